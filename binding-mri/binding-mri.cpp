@@ -30,16 +30,27 @@
 #include "graphics.h"
 #include "audio.h"
 #include "boost-hash.h"
+#include "scriptcache.h"
 
 #include <ruby.h>
 #include <ruby/encoding.h>
+#include <ruby/version.h>
 
 #include <assert.h>
+#include <string.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <zlib.h>
 
+#include <SDL_cpuinfo.h>
 #include <SDL_filesystem.h>
 
+#if RUBY_API_VERSION_MAJOR > 2 || (RUBY_API_VERSION_MAJOR == 2 && RUBY_API_VERSION_MINOR >= 3)
+/* RubyVM::InstructionSequence#to_binary / ::load_from_binary */
+#define HAVE_ISEQ_BINARY
+#endif
+
 extern const char module_rpg1[];
 extern const char module_rpg2[];
 extern const char module_rpg3[];
@@ -354,6 +365,74 @@ static VALUE evalString(VALUE string, VALUE filename, int *state)
 	return rb_protect((VALUE (*)(VALUE))evalHelper, (VALUE)&arg, state);
 }
 
+#ifdef HAVE_ISEQ_BINARY
+static VALUE iseqClass()
+{
+	return rb_path2class("RubyVM::InstructionSequence");
+}
+
+static VALUE iseqCompileHelper(evalArg *arg)
+{
+	VALUE argv[] = { arg->string, arg->filename, arg->filename, INT2FIX(1) };
+	return rb_funcall2(iseqClass(), rb_intern("compile"), ARRAY_SIZE(argv), argv);
+}
+
+static VALUE iseqLoadHelper(VALUE binary)
+{
+	return rb_funcall2(iseqClass(), rb_intern("load_from_binary"), 1, &binary);
+}
+
+static VALUE iseqDumpHelper(VALUE iseq)
+{
+	return rb_funcall2(iseq, rb_intern("to_binary"), 0, NULL);
+}
+
+static VALUE iseqEvalHelper(VALUE iseq)
+{
+	return rb_funcall2(iseq, rb_intern("eval"), 0, NULL);
+}
+
+/* Returns nil if the section doesn't compile; the error
+ * is then raised by evalString() when it's run */
+static VALUE compileSection(ScriptCache &cache, size_t index,
+                            uint32_t chksum, uint32_t srcCrc,
+                            VALUE string, VALUE filename)
+{
+	int state;
+
+	if (const std::string *cached = cache.lookup(index, chksum, srcCrc))
+	{
+		VALUE binary = rb_str_new(cached->data(), cached->size());
+		VALUE iseq = rb_protect(iseqLoadHelper, binary, &state);
+
+		if (!state)
+			return iseq;
+
+		/* Written by an incompatible build */
+		rb_set_errinfo(Qnil);
+	}
+
+	evalArg arg = { string, filename };
+	VALUE iseq = rb_protect((VALUE (*)(VALUE))iseqCompileHelper, (VALUE)&arg, &state);
+
+	if (state)
+	{
+		rb_set_errinfo(Qnil);
+		return Qnil;
+	}
+
+	VALUE binary = rb_protect(iseqDumpHelper, iseq, &state);
+
+	if (state)
+		rb_set_errinfo(Qnil);
+	else
+		cache.store(index, chksum, srcCrc,
+		            std::string(RSTRING_PTR(binary), RSTRING_LEN(binary)));
+
+	return iseq;
+}
+#endif
+
 static void runCustomScript(const std::string &filename)
 {
 	std::string scriptData;
@@ -378,6 +457,123 @@ struct BacktraceData
 
 #define SCRIPT_SECTION_FMT (rgssVer >= 3 ? "{%04ld}" : "Section%03ld")
 
+static bool inflateSection(std::string &arena, const Bytef *src, uLong srcLen)
+{
+	z_stream zs;
+	memset(&zs, 0, sizeof(zs));
+
+	if (inflateInit(&zs) != Z_OK)
+		return false;
+
+	zs.next_in = const_cast<Bytef*>(src);
+	zs.avail_in = srcLen;
+
+	const size_t start = arena.size();
+	int result = Z_OK;
+
+	while (result == Z_OK)
+	{
+		const size_t used = start + zs.total_out;
+
+		if (arena.size() - used < 0x1000)
+			arena.resize(std::max<size_t>(arena.size() * 2, used + 0x10000));
+
+		zs.next_out = reinterpret_cast<Bytef*>(&arena[used]);
+		zs.avail_out = arena.size() - used;
+
+		result = inflate(&zs, Z_NO_FLUSH);
+	}
+
+	arena.resize(start + zs.total_out);
+	inflateEnd(&zs);
+
+	return result == Z_STREAM_END;
+}
+
+/* Inflates the script sections on a pool of worker threads
+ * (the calling one included). Every worker appends to its own
+ * arena, so there is one growing buffer per thread rather than
+ * an allocation per section. Only plain C data is touched off
+ * the Ruby thread, which waits for the workers */
+struct ScriptDecoder
+{
+	struct Section
+	{
+		const Bytef *src;
+		uLong srcLen;
+
+		size_t arena;
+		size_t offset;
+		size_t length;
+		bool ok;
+	};
+
+	std::vector<Section> sections;
+	std::vector<std::string> arenas;
+
+	SDL_atomic_t nextSection;
+	SDL_atomic_t nextArena;
+
+	void add(VALUE compressed)
+	{
+		Section s;
+		s.src = reinterpret_cast<const Bytef*>(RSTRING_PTR(compressed));
+		s.srcLen = RSTRING_LEN(compressed);
+		s.arena = s.offset = s.length = 0;
+		s.ok = false;
+
+		sections.push_back(s);
+	}
+
+	void decode()
+	{
+		SDL_AtomicSet(&nextSection, 0);
+		SDL_AtomicSet(&nextArena, 0);
+
+		const int workers = clamp<int>(SDL_GetCPUCount(), 1, 8);
+		const size_t threadCount = std::min<size_t>(workers, sections.size());
+
+		arenas.resize(std::max<size_t>(threadCount, 1));
+
+		std::vector<SDL_Thread*> threads;
+
+		for (size_t i = 1; i < threadCount; ++i)
+			threads.push_back(createSDLThread
+				<ScriptDecoder, &ScriptDecoder::workerFun>(this, "scriptdecode"));
+
+		workerFun();
+
+		for (size_t i = 0; i < threads.size(); ++i)
+			if (threads[i])
+				SDL_WaitThread(threads[i], 0);
+	}
+
+	const char *data(const Section &s) const
+	{
+		return arenas[s.arena].data() + s.offset;
+	}
+
+	void workerFun()
+	{
+		const size_t arenaIdx = SDL_AtomicAdd(&nextArena, 1);
+		std::string &arena = arenas[arenaIdx];
+
+		while (true)
+		{
+			const size_t i = SDL_AtomicAdd(&nextSection, 1);
+
+			if (i >= sections.size())
+				break;
+
+			Section &s = sections[i];
+			s.arena = arenaIdx;
+			s.offset = arena.size();
+			s.ok = inflateSection(arena, s.src, s.srcLen);
+			s.length = arena.size() - s.offset;
+		}
+	}
+};
+
 static void runRMXPScripts(BacktraceData &btData)
 {
 	const Config &conf = shState->rtData().config;
@@ -419,8 +615,9 @@ static void runRMXPScripts(BacktraceData &btData)
 
 	long scriptCount = RARRAY_LEN(scriptArray);
 
-	std::string decodeBuffer;
-	decodeBuffer.resize(0x1000);
+	/* Maps: decoder section, To: index in script array */
+	std::vector<long> sectionScripts;
+	ScriptDecoder decoder;
 
 	for (long i = 0; i < scriptCount; ++i)
 	{
@@ -429,46 +626,39 @@ static void runRMXPScripts(BacktraceData &btData)
 		if (!RB_TYPE_P(script, RUBY_T_ARRAY))
 			continue;
 
-		VALUE scriptName   = rb_ary_entry(script, 1);
 		VALUE scriptString = rb_ary_entry(script, 2);
 
-		int result = Z_OK;
-		unsigned long bufferLen;
-
-		while (true)
-		{
-			unsigned char *bufferPtr =
-			        reinterpret_cast<unsigned char*>(const_cast<char*>(decodeBuffer.c_str()));
-			const unsigned char *sourcePtr =
-			        reinterpret_cast<const unsigned char*>(RSTRING_PTR(scriptString));
-
-			bufferLen = decodeBuffer.length();
-
-			result = uncompress(bufferPtr, &bufferLen,
-			                    sourcePtr, RSTRING_LEN(scriptString));
+		if (!RB_TYPE_P(scriptString, RUBY_T_STRING))
+			continue;
 
-			bufferPtr[bufferLen] = '\0';
+		decoder.add(scriptString);
+		sectionScripts.push_back(i);
+	}
 
-			if (result != Z_BUF_ERROR)
-				break;
+	decoder.decode();
 
-			decodeBuffer.resize(decodeBuffer.size()*2);
-		}
+	for (size_t j = 0; j < decoder.sections.size(); ++j)
+	{
+		const ScriptDecoder::Section &section = decoder.sections[j];
+		VALUE script = rb_ary_entry(scriptArray, sectionScripts[j]);
 
-		if (result != Z_OK)
+		if (!section.ok)
 		{
 			static char buffer[256];
 			snprintf(buffer, sizeof(buffer), "Error decoding script %ld: '%s'",
-			         i, RSTRING_PTR(scriptName));
+			         sectionScripts[j], RSTRING_PTR(rb_ary_entry(script, 1)));
 
 			showMsg(buffer);
 
-			break;
+			return;
 		}
 
-		rb_ary_store(script, 3, rb_str_new_cstr(decodeBuffer.c_str()));
+		rb_ary_store(script, 3, rb_str_new(decoder.data(section), section.length));
 	}
 
+	/* The decoded sections are held by the script array now */
+	decoder.arenas.clear();
+
 	/* Execute preloaded scripts */
 	for (std::set<std::string>::iterator i = conf.preloadScripts.begin();
 	     i != conf.preloadScripts.end(); ++i)
@@ -478,30 +668,73 @@ static void runRMXPScripts(BacktraceData &btData)
 	if (exc != Qnil)
 		return;
 
+	/* Per section: [source, filename, compiled ISeq or nil] */
+	VALUE sections = rb_ary_new2(sectionScripts.size());
+
+#ifdef HAVE_ISEQ_BINARY
+	/* The file names end up in the binaries */
+	ScriptCache cache(conf, std::string("mri ") + ruby_version +
+	                  (conf.useScriptNames ? " names" : ""), sectionScripts.size());
+#endif
+
+	for (size_t j = 0; j < sectionScripts.size(); ++j)
+	{
+		const long i = sectionScripts[j];
+		VALUE script = rb_ary_entry(scriptArray, i);
+		VALUE scriptDecoded = rb_ary_entry(script, 3);
+		VALUE string = newStringUTF8(RSTRING_PTR(scriptDecoded),
+		                             RSTRING_LEN(scriptDecoded));
+
+		VALUE fname;
+		const char *scriptName = RSTRING_PTR(rb_ary_entry(script, 1));
+		char buf[512];
+		int len;
+
+		if (conf.useScriptNames)
+			len = snprintf(buf, sizeof(buf), "%03ld:%s", i, scriptName);
+		else
+			len = snprintf(buf, sizeof(buf), SCRIPT_SECTION_FMT, i);
+
+		fname = newStringUTF8(buf, len);
+		btData.scriptNames.insert(buf, scriptName);
+
+		VALUE iseq = Qnil;
+
+#ifdef HAVE_ISEQ_BINARY
+		VALUE scriptChksum = rb_ary_entry(script, 0);
+		VALUE scriptString = rb_ary_entry(script, 2);
+
+		const uint32_t chksum = FIXNUM_P(scriptChksum) ? FIX2LONG(scriptChksum) : 0;
+		const uint32_t srcCrc = crc32(0, reinterpret_cast<const Bytef*>(RSTRING_PTR(scriptString)),
+		                              RSTRING_LEN(scriptString));
+
+		iseq = compileSection(cache, j, chksum, srcCrc, string, fname);
+#endif
+
+		VALUE section[] = { string, fname, iseq };
+		rb_ary_push(sections, rb_ary_new4(ARRAY_SIZE(section), section));
+	}
+
+#ifdef HAVE_ISEQ_BINARY
+	cache.flush();
+#endif
+
 	while (true)
 	{
-		for (long i = 0; i < scriptCount; ++i)
+		for (long j = 0; j < RARRAY_LEN(sections); ++j)
 		{
-			VALUE script = rb_ary_entry(scriptArray, i);
-			VALUE scriptDecoded = rb_ary_entry(script, 3);
-			VALUE string = newStringUTF8(RSTRING_PTR(scriptDecoded),
-			                             RSTRING_LEN(scriptDecoded));
-
-			VALUE fname;
-			const char *scriptName = RSTRING_PTR(rb_ary_entry(script, 1));
-			char buf[512];
-			int len;
-
-			if (conf.useScriptNames)
-				len = snprintf(buf, sizeof(buf), "%03ld:%s", i, scriptName);
-			else
-				len = snprintf(buf, sizeof(buf), SCRIPT_SECTION_FMT, i);
+			VALUE section = rb_ary_entry(sections, j);
+			int state;
 
-			fname = newStringUTF8(buf, len);
-			btData.scriptNames.insert(buf, scriptName);
+#ifdef HAVE_ISEQ_BINARY
+			VALUE iseq = rb_ary_entry(section, 2);
+
+			if (!NIL_P(iseq))
+				rb_protect(iseqEvalHelper, iseq, &state);
+			else
+#endif
+				evalString(rb_ary_entry(section, 0), rb_ary_entry(section, 1), &state);
 
-			int state;
-			evalString(string, fname, &state);
 			if (state)
 				break;
 		}
@@ -512,6 +745,8 @@ static void runRMXPScripts(BacktraceData &btData)
 
 		processReset();
 	}
+
+	RB_GC_GUARD(sections);
 }
 
 static void showExc(VALUE exc, const BacktraceData &btData)
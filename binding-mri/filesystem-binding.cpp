@@ -22,9 +22,14 @@
 #include "binding-util.h"
 
 #include "sharedstate.h"
+#include "eventthread.h"
 #include "filesystem.h"
+#include "prefetcher.h"
+#include "savewriter.h"
 #include "util.h"
 
+#include <string>
+
 #include "ruby/encoding.h"
 #include "ruby/intern.h"
 
@@ -122,19 +127,44 @@ RB_METHOD(fileIntBinmode)
 	return Qnil;
 }
 
+/* marshal-load.cpp */
+VALUE marshalLoadNative(VALUE data);
+
 VALUE
 kernelLoadDataInt(const char *filename, bool rubyExc)
 {
 	rb_gc_start();
 
-	VALUE port = fileIntForPath(filename, rubyExc);
+	/* Pending saves first, in case this is one of them */
+	shState->saveWriter().flush();
+	shState->prefetcher().demand(filename);
+
+	VALUE file = fileIntForPath(filename, rubyExc);
+	VALUE port = file;
 
 	VALUE marsh = rb_const_get(rb_cObject, rb_intern("Marshal"));
+	VALUE result = Qundef;
+
+	if (shState->rtData().config.nativeMarshal)
+	{
+		/* The generic loader takes the string too,
+		 * so the file is only read once either way */
+		VALUE length = INT2FIX(-1);
+		port = rb_funcall2(file, rb_intern("read"), 1, &length);
+
+		if (NIL_P(port))
+			port = rb_str_new(0, 0);
+
+		result = marshalLoadNative(port);
+	}
 
 	// FIXME need to catch exceptions here with begin rescue
-	VALUE result = rb_funcall2(marsh, rb_intern("load"), 1, &port);
+	if (result == Qundef)
+		result = rb_funcall2(marsh, rb_intern("load"), 1, &port);
+
+	rb_funcall2(file, rb_intern("close"), 0, NULL);
 
-	rb_funcall2(port, rb_intern("close"), 0, NULL);
+	shState->prefetcher().dataLoaded(filename);
 
 	return result;
 }
@@ -158,14 +188,19 @@ RB_METHOD(kernelSaveData)
 
 	rb_get_args(argc, argv, "oS", &obj, &filename RB_ARG_END);
 
-	VALUE file = rb_file_open_str(filename, "wb");
-
 	VALUE marsh = rb_const_get(rb_cObject, rb_intern("Marshal"));
+	VALUE dumped = rb_funcall2(marsh, rb_intern("dump"), 1, &obj);
 
-	VALUE v[] = { obj, file };
-	rb_funcall2(marsh, rb_intern("dump"), ARRAY_SIZE(v), v);
+	std::string data(RSTRING_PTR(dumped), RSTRING_LEN(dumped));
 
-	rb_io_close(file);
+	try
+	{
+		shState->saveWriter().write(StringValueCStr(filename), data);
+	}
+	catch (const Exception &e)
+	{
+		raiseRbExc(e);
+	}
 
 	return Qnil;
 }
@@ -206,6 +241,47 @@ RB_METHOD(_marshalLoad)
 	return rb_funcall2(marsh, rb_intern("_mkxp_load_alias"), ARRAY_SIZE(v), v);
 }
 
+/* File / FileTest functions that can see a save_data target;
+ * they wait for pending writes, like load_data does */
+static const char *flushingFileFuncs[] =
+{
+	"exist?", "exists?", "file?", "size", "size?", "zero?",
+	"open", "new", "read", "binread", "readlines", "foreach",
+	"mtime", "stat", "delete", "unlink", "rename"
+};
+
+static std::string flushingAliasName(const char *name)
+{
+	return std::string("_mkxp_") + name + "_alias";
+}
+
+RB_METHOD(fileFlushingCall)
+{
+	shState->saveWriter().flush();
+
+	const std::string alias = flushingAliasName(rb_id2name(rb_frame_this_func()));
+
+	return rb_funcall_passing_block(self, rb_intern(alias.c_str()), argc, argv);
+}
+
+static void
+defineFlushingFileFuncs(VALUE module)
+{
+	VALUE singleton = rb_singleton_class(module);
+
+	for (size_t i = 0; i < ARRAY_SIZE(flushingFileFuncs); ++i)
+	{
+		const char *name = flushingFileFuncs[i];
+
+		/* Not every Ruby version has all of them */
+		if (!rb_respond_to(module, rb_intern(name)))
+			continue;
+
+		rb_define_alias(singleton, flushingAliasName(name).c_str(), name);
+		rb_define_singleton_method(module, name, RUBY_METHOD_FUNC(fileFlushingCall), -1);
+	}
+}
+
 void
 fileIntBindingInit()
 {
@@ -226,4 +302,7 @@ fileIntBindingInit()
 	VALUE marsh = rb_const_get(rb_cObject, rb_intern("Marshal"));
 	rb_define_alias(rb_singleton_class(marsh), "_mkxp_load_alias", "load");
 	_rb_define_module_function(marsh, "load", _marshalLoad);
+
+	defineFlushingFileFuncs(rb_mFileTest);
+	defineFlushingFileFuncs(rb_cFile);
 }
@@ -0,0 +1,504 @@
+/*
+** marshal-load.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binding-util.h"
+#include "binding-types.h"
+#include "exception.h"
+#include "table.h"
+#include "etc.h"
+
+#include <ruby/encoding.h>
+#include <ruby/version.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <vector>
+
+/* Native Marshal.load for game data, replacing the generic loader
+ * and the UTF-8 proc mkxp passes it (which costs a block call per
+ * loaded object). Class paths are resolved once per stream symbol,
+ * ivar names are interned once, and Table/Color/Tone skip their
+ * _load. Strings without an encoding come out as UTF-8, like with
+ * the proc.
+ *
+ * Anything unusual (structs, extended objects, user marshal,
+ * regexps, data objects...) throws Unsupported, as does every
+ * Ruby exception raised while loading; the caller then retries
+ * with the generic loader, which raises the proper error */
+
+struct Unsupported {};
+
+struct MarshalReader
+{
+	struct Symbol
+	{
+		/* Points into the stream */
+		const char *name;
+		long len;
+		ID id;
+
+		/* Resolved on first use as a class name */
+		VALUE klass;
+	};
+
+	const uint8_t *p;
+	const uint8_t *end;
+
+	/* Everything '@' can link back to; also keeps all
+	 * objects built so far reachable for the GC */
+	VALUE objects;
+
+	std::vector<Symbol> symbols;
+
+	VALUE tableClass;
+	VALUE colorClass;
+	VALUE toneClass;
+
+	MarshalReader(VALUE data)
+	    : p(reinterpret_cast<const uint8_t*>(RSTRING_PTR(data))),
+	      end(p + RSTRING_LEN(data)),
+	      objects(rb_ary_new())
+	{
+		tableClass = rb_const_get(rb_cObject, rb_intern("Table"));
+		colorClass = rb_const_get(rb_cObject, rb_intern("Color"));
+		toneClass = rb_const_get(rb_cObject, rb_intern("Tone"));
+	}
+
+	uint8_t readByte()
+	{
+		if (p >= end)
+			throw Unsupported();
+
+		return *p++;
+	}
+
+	long readInt()
+	{
+		const int8_t c = (int8_t) readByte();
+
+		if (c == 0)
+			return 0;
+
+		if (c > 4)
+			return c - 5;
+
+		if (c < -4)
+			return c + 5;
+
+		long x = c > 0 ? 0 : -1;
+
+		for (int i = 0; i < (c > 0 ? c : -c); ++i)
+		{
+			x &= ~(0xFFL << (8*i));
+			x |= (long) readByte() << (8*i);
+		}
+
+		return x;
+	}
+
+	/* Element counts can't exceed what's left of the stream */
+	long readCount()
+	{
+		const long n = readInt();
+
+		if (n < 0 || n > end - p)
+			throw Unsupported();
+
+		return n;
+	}
+
+	const char *readBytes(long &len)
+	{
+		len = readCount();
+
+		const char *data = reinterpret_cast<const char*>(p);
+		p += len;
+
+		return data;
+	}
+
+	VALUE entry(VALUE obj)
+	{
+		rb_ary_push(objects, obj);
+
+		return obj;
+	}
+
+	bool isIvar(const Symbol &s, const char *name)
+	{
+		return s.len == (long) strlen(name) && memcmp(s.name, name, s.len) == 0;
+	}
+
+	/* Index into 'symbols' */
+	size_t symbol()
+	{
+		switch (readByte())
+		{
+		case ':' :
+		{
+			Symbol s;
+			s.name = readBytes(s.len);
+			s.id = rb_intern2(s.name, s.len);
+			s.klass = Qnil;
+
+			symbols.push_back(s);
+
+			return symbols.size() - 1;
+		}
+
+		case ';' :
+		{
+			const long idx = readInt();
+
+			if (idx < 0 || idx >= (long) symbols.size())
+				throw Unsupported();
+
+			return idx;
+		}
+
+		case 'I' :
+		{
+			/* Symbol with encoding; re-intern it in
+			 * UTF-8 if it isn't plain ASCII */
+			if (readByte() != ':')
+				throw Unsupported();
+
+			--p;
+			const size_t idx = symbol();
+
+			for (long n = readCount(); n > 0; --n)
+			{
+				const size_t ivar = symbol();
+				VALUE v = value();
+
+				if (isIvar(symbols[ivar], "E") && v == Qtrue)
+				{
+					Symbol &s = symbols[idx];
+					s.id = rb_intern3(s.name, s.len, rb_utf8_encoding());
+				}
+			}
+
+			return idx;
+		}
+
+		default :
+			throw Unsupported();
+		}
+	}
+
+	VALUE classFor(size_t idx)
+	{
+		Symbol &s = symbols[idx];
+
+		if (NIL_P(s.klass))
+			s.klass = rb_path_to_class(rb_str_new(s.name, s.len));
+
+		return s.klass;
+	}
+
+	/* Encoding ivars as written by Ruby 1.9+ */
+	void stringIvars(VALUE str)
+	{
+		for (long n = readCount(); n > 0; --n)
+		{
+			const size_t idx = symbol();
+			const ID id = symbols[idx].id;
+			VALUE v = value();
+
+			if (isIvar(symbols[idx], "E"))
+			{
+				if (v == Qfalse)
+					rb_enc_associate_index(str, rb_usascii_encindex());
+			}
+			else if (isIvar(symbols[idx], "encoding"))
+			{
+				const int enc = rb_enc_find_index(StringValueCStr(v));
+
+				if (enc >= 0)
+					rb_enc_associate_index(str, enc);
+			}
+			else
+			{
+				rb_ivar_set(str, id, v);
+			}
+		}
+	}
+
+	VALUE string()
+	{
+		long len;
+		const char *data = readBytes(len);
+
+		return entry(rb_enc_str_new(data, len, rb_utf8_encoding()));
+	}
+
+	VALUE floatValue()
+	{
+		long len;
+		const char *data = readBytes(len);
+
+		/* Ruby 1.8 appended mantissa bytes after a NUL */
+		char buf[64];
+		const size_t n = len < (long) sizeof(buf) ? len : sizeof(buf) - 1;
+		memcpy(buf, data, n);
+		buf[n] = '\0';
+
+		return entry(DBL2NUM(strtod(buf, 0)));
+	}
+
+	VALUE bignum()
+	{
+#if RUBY_API_VERSION_MAJOR > 2 || (RUBY_API_VERSION_MAJOR == 2 && RUBY_API_VERSION_MINOR >= 1)
+		const uint8_t sign = readByte();
+		const long shorts = readCount();
+
+		if (end - p < shorts * 2)
+			throw Unsupported();
+
+		int flags = INTEGER_PACK_LITTLE_ENDIAN;
+
+		if (sign == '-')
+			flags |= INTEGER_PACK_NEGATIVE;
+
+		VALUE big = rb_integer_unpack(p, shorts * 2, 1, 0, flags);
+		p += shorts * 2;
+
+		return entry(big);
+#else
+		throw Unsupported();
+#endif
+	}
+
+	VALUE array()
+	{
+		const long n = readCount();
+		VALUE ary = entry(rb_ary_new2(n));
+
+		for (long i = 0; i < n; ++i)
+			rb_ary_push(ary, value());
+
+		return ary;
+	}
+
+	VALUE hash(bool withDefault)
+	{
+		const long n = readCount();
+#if RUBY_API_VERSION_MAJOR > 3 || (RUBY_API_VERSION_MAJOR == 3 && RUBY_API_VERSION_MINOR >= 2)
+		VALUE hash = entry(rb_hash_new_capa(n));
+#else
+		VALUE hash = entry(rb_hash_new());
+#endif
+
+		for (long i = 0; i < n; ++i)
+		{
+			VALUE key = value();
+			rb_hash_aset(hash, key, value());
+		}
+
+		if (withDefault)
+		{
+			VALUE def = value();
+			rb_funcall2(hash, rb_intern("default="), 1, &def);
+		}
+
+		return hash;
+	}
+
+	VALUE object()
+	{
+		VALUE obj = rb_obj_alloc(classFor(symbol()));
+
+		if (!RB_TYPE_P(obj, RUBY_T_OBJECT))
+			throw Unsupported();
+
+		entry(obj);
+
+		for (long n = readCount(); n > 0; --n)
+		{
+			const ID ivar = symbols[symbol()].id;
+			rb_ivar_set(obj, ivar, value());
+		}
+
+		return obj;
+	}
+
+	template<class C>
+	VALUE deserialize(VALUE klass, const char *data, long len)
+	{
+		VALUE obj = rb_obj_alloc(klass);
+		setPrivateData(obj, C::deserialize(data, len));
+
+		return obj;
+	}
+
+	VALUE userType(bool withIvars)
+	{
+		VALUE klass = classFor(symbol());
+
+		long len;
+		const char *data = readBytes(len);
+
+		if (klass == tableClass && !withIvars)
+			return entry(deserialize<Table>(klass, data, len));
+
+		if (klass == colorClass && !withIvars)
+			return entry(deserialize<Color>(klass, data, len));
+
+		if (klass == toneClass && !withIvars)
+			return entry(deserialize<Tone>(klass, data, len));
+
+		VALUE str = rb_str_new(data, len);
+
+		if (withIvars)
+			stringIvars(str);
+
+		return entry(rb_funcall2(klass, rb_intern("_load"), 1, &str));
+	}
+
+	VALUE ivarWrapped()
+	{
+		switch (readByte())
+		{
+		case '"' :
+		{
+			VALUE str = string();
+			stringIvars(str);
+
+			return str;
+		}
+
+		case 'u' :
+			return userType(true);
+
+		case ':' :
+			p -= 2;
+			return ID2SYM(symbols[symbol()].id);
+
+		default :
+			throw Unsupported();
+		}
+	}
+
+	VALUE value()
+	{
+		const uint8_t type = readByte();
+
+		switch (type)
+		{
+		case '0' :
+			return Qnil;
+
+		case 'T' :
+			return Qtrue;
+
+		case 'F' :
+			return Qfalse;
+
+		case 'i' :
+			return LONG2NUM(readInt());
+
+		case ':' :
+		case ';' :
+			--p;
+			return ID2SYM(symbols[symbol()].id);
+
+		case '@' :
+		{
+			const long idx = readInt();
+
+			if (idx < 0 || idx >= RARRAY_LEN(objects))
+				throw Unsupported();
+
+			return rb_ary_entry(objects, idx);
+		}
+
+		case '"' :
+			return string();
+
+		case 'f' :
+			return floatValue();
+
+		case 'l' :
+			return bignum();
+
+		case '[' :
+			return array();
+
+		case '{' :
+		case '}' :
+			return hash(type == '}');
+
+		case 'o' :
+			return object();
+
+		case 'u' :
+			return userType(false);
+
+		case 'I' :
+			return ivarWrapped();
+
+		default :
+			throw Unsupported();
+		}
+	}
+};
+
+static VALUE loadProtected(VALUE arg)
+{
+	MarshalReader *reader = reinterpret_cast<MarshalReader*>(arg);
+
+	try
+	{
+		if (reader->readByte() != 4 || reader->readByte() != 8)
+			return Qundef;
+
+		return reader->value();
+	}
+	catch (const Unsupported &)
+	{
+		return Qundef;
+	}
+	catch (const Exception &)
+	{
+		/* Damaged Table/Color/Tone data */
+		return Qundef;
+	}
+}
+
+/* Qundef if 'data' has to go through the generic loader */
+VALUE marshalLoadNative(VALUE data)
+{
+	MarshalReader reader(data);
+
+	int state;
+	VALUE result = rb_protect(loadProtected, (VALUE) &reader, &state);
+
+	if (state)
+	{
+		rb_set_errinfo(Qnil);
+		return Qundef;
+	}
+
+	RB_GC_GUARD(reader.objects);
+	RB_GC_GUARD(data);
+
+	return result;
+}
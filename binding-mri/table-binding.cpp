@@ -21,7 +21,9 @@
 
 #include <algorithm>
 #include "table.h"
+#include "etc.h"
 #include "binding-util.h"
+#include "binding-types.h"
 #include "serializable-binding.h"
 
 static int num2TableSize(VALUE v)
@@ -155,6 +157,80 @@ RB_METHOD(tableSetAt)
 	return argv[argc - 1];
 }
 
+RB_METHOD(tableFill)
+{
+	Table *t = getPrivateData<Table>(self);
+
+	int value, z = 0;
+	VALUE rectObj;
+
+	rb_get_args(argc, argv, "io|i", &value, &rectObj, &z RB_ARG_END);
+
+	Rect *rect = getPrivateDataCheck<Rect>(rectObj, RectType);
+
+	t->fill(value, rect->toIntRect(), z);
+
+	return self;
+}
+
+RB_METHOD(tableBlit)
+{
+	Table *t = getPrivateData<Table>(self);
+
+	VALUE srcObj, rectObj;
+	int dx, dy;
+
+	rb_get_args(argc, argv, "ooii", &srcObj, &rectObj, &dx, &dy RB_ARG_END);
+
+	Table *src = getPrivateDataCheck<Table>(srcObj, TableType);
+	Rect *rect = getPrivateDataCheck<Rect>(rectObj, RectType);
+
+	t->blit(*src, rect->toIntRect(), dx, dy);
+
+	return self;
+}
+
+RB_METHOD(tableReplaceAll)
+{
+	Table *t = getPrivateData<Table>(self);
+
+	int from, to;
+
+	rb_get_args(argc, argv, "ii", &from, &to RB_ARG_END);
+
+	return INT2NUM(t->replaceAll(from, to));
+}
+
+RB_METHOD(tableToS)
+{
+	RB_UNUSED_PARAM;
+
+	Table *t = getPrivateData<Table>(self);
+
+	VALUE data = rb_str_new(0, t->rawSize());
+	t->readRaw(RSTRING_PTR(data));
+
+	return data;
+}
+
+RB_METHOD(tableFromS)
+{
+	Table *t = getPrivateData<Table>(self);
+
+	const char *data;
+	int dataLen;
+
+	rb_get_args(argc, argv, "s", &data, &dataLen RB_ARG_END);
+
+	if (dataLen != t->rawSize())
+		rb_raise(rb_eArgError, "Table data size mismatch (%d bytes, expected %d)",
+		         dataLen, t->rawSize());
+
+	t->writeRaw(data);
+
+	return self;
+}
+
 MARSH_LOAD_FUN(Table)
 INITCOPY_FUN(Table)
 
@@ -176,5 +252,10 @@ tableBindingInit()
 	_rb_define_method(klass, "zsize", tableZSize);
 	_rb_define_method(klass, "[]", tableGetAt);
 	_rb_define_method(klass, "[]=", tableSetAt);
+	_rb_define_method(klass, "fill", tableFill);
+	_rb_define_method(klass, "blit", tableBlit);
+	_rb_define_method(klass, "replace_all", tableReplaceAll);
+	_rb_define_method(klass, "to_s", tableToS);
+	_rb_define_method(klass, "from_s", tableFromS);
 
 }
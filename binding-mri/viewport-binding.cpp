@@ -83,6 +83,19 @@ DEF_PROP_OBJ_VAL(Viewport, Tone,  Tone,  "tone")
 DEF_PROP_I(Viewport, OX)
 DEF_PROP_I(Viewport, OY)
 
+DEF_PROP_B(Viewport, Cache)
+
+RB_METHOD(viewportRefresh)
+{
+	RB_UNUSED_PARAM;
+
+	Viewport *v = getPrivateData<Viewport>(self);
+
+	GUARD_EXC( v->refresh(); )
+
+	return Qnil;
+}
+
 
 void
 viewportBindingInit()
@@ -101,5 +114,8 @@ viewportBindingInit()
 	INIT_PROP_BIND( Viewport, OY,    "oy"    );
 	INIT_PROP_BIND( Viewport, Color, "color" );
 	INIT_PROP_BIND( Viewport, Tone,  "tone"  );
+	INIT_PROP_BIND( Viewport, Cache, "cache" );
+
+	_rb_define_method(klass, "refresh", viewportRefresh);
 }
 
@@ -29,7 +29,9 @@
 #include <mruby/compile.h>
 #include <mruby/proc.h>
 #include <mruby/dump.h>
+#include <mruby/version.h>
 
+#include <stdint.h>
 #include <stdio.h>
 #include <zlib.h>
 
@@ -44,10 +46,12 @@
 #include "eventthread.h"
 #include "filesystem.h"
 #include "exception.h"
+#include "scriptcache.h"
 
 #include "binding-util.h"
 #include "binding-types.h"
 #include "mrb-ext/marshal.h"
+#include "mrb-ext/marshal-load.h"
 #include "mrb-ext/file-helper.h"
 
 #include <stdio.h>
@@ -250,6 +254,104 @@ runMrbFile(mrb_state *mrb, const char *filename)
 #endif
 }
 
+/* Parses and compiles without executing; every script gets a fresh
+ * parser context, so top level locals don't leak between scripts
+ * (as in RGSS, where each script is evaluated on its own) */
+static mrb_irep *
+compileScript(mrb_state *mrb, const mrbc_context *ctx, const char *name,
+              const char *source, size_t sourceLen, std::string &dump)
+{
+	mrbc_context *compileCtx = mrbc_context_new(mrb);
+	mrbc_filename(mrb, compileCtx, name);
+	compileCtx->capture_errors = ctx->capture_errors;
+	compileCtx->no_exec = TRUE;
+
+	int ai = mrb_gc_arena_save(mrb);
+
+	mrb_value proc = mrb_load_nstring_cxt(mrb, source, sourceLen, compileCtx);
+	mrb_irep *irep = 0;
+
+	if (mrb_type(proc) == MRB_TT_PROC)
+	{
+		irep = mrb_proc_ptr(proc)->body.irep;
+		mrb_irep_incref(mrb, irep);
+
+		uint8_t *bin;
+		size_t binSize;
+
+		if (mrb_dump_irep(mrb, irep, DUMP_DEBUG_INFO, &bin, &binSize) == MRB_DUMP_OK)
+		{
+			dump.assign((const char*) bin, binSize);
+			mrb_free(mrb, bin);
+		}
+	}
+
+	mrb_gc_arena_restore(mrb, ai);
+	mrbc_context_free(mrb, compileCtx);
+
+	return irep;
+}
+
+/* Inflates and compiles script 'index', storing the result in
+ * 'cache'. Reports the error and returns null on failure */
+static mrb_irep *decodeAndCompile(mrb_state *mrb, mrbc_context *ctx, ScriptCache &cache,
+                                  int index, uint32_t chksum, uint32_t srcCrc,
+                                  mrb_value scriptName, mrb_value scriptString,
+                                  std::string &decodeBuffer)
+{
+	int result = Z_OK;
+	unsigned long bufferLen;
+
+	while (true)
+	{
+		unsigned char *bufferPtr =
+		        reinterpret_cast<unsigned char*>(const_cast<char*>(decodeBuffer.c_str()));
+		unsigned char *sourcePtr =
+		        reinterpret_cast<unsigned char*>(RSTRING_PTR(scriptString));
+
+		bufferLen = decodeBuffer.length();
+
+		result = uncompress(bufferPtr, &bufferLen,
+		                    sourcePtr, RSTRING_LEN(scriptString));
+
+		bufferPtr[bufferLen] = '\0';
+
+		if (result != Z_BUF_ERROR)
+			break;
+
+		decodeBuffer.resize(decodeBuffer.size()*2);
+	}
+
+	if (result != Z_OK)
+	{
+		static char buffer[256];
+		snprintf(buffer, sizeof(buffer), "Error decoding script %d: '%s'",
+		         index, RSTRING_PTR(scriptName));
+
+		showError(buffer);
+
+		return 0;
+	}
+
+	std::string dump;
+	mrb_irep *irep = compileScript(mrb, ctx, RSTRING_PTR(scriptName),
+	                               decodeBuffer.c_str(), bufferLen, dump);
+
+	if (!dump.empty())
+		cache.store(index, chksum, srcCrc, dump);
+
+	if (!irep || mrb->exc) {
+		printf("%s - err\n", RSTRING_PTR(scriptName));
+
+		if (irep)
+			mrb_irep_decref(mrb, irep);
+
+		return 0;
+	}
+
+	return irep;
+}
+
 mrb_state * static_mrb;
 
 #ifdef __EMSCRIPTEN__
@@ -334,19 +436,13 @@ runRMXPScripts(mrb_state *mrb, mrbc_context *ctx)
 		return;
 	}
 
-	/* We use a secondary util state to unmarshal the scripts */
-	mrb_state *scriptMrb = mrb_open();
-
 	mrb_value scriptArray = mrb_nil_value();
 	std::string readError;
 
 	try
 	{
-		SDL_rw_file_helper fileHelper;
-		fileHelper.filename = scriptPack.c_str();
-		char * contents = fileHelper.read();
-		mrb_value rawdata = mrb_str_new_static(mrb, contents, fileHelper.length);
-		scriptArray = mrb_marshal_load(mrb, rawdata);
+		mrb_value rawdata = readFileString(mrb, scriptPack.c_str());
+		scriptArray = marshalLoad(mrb, rawdata);
 	}
 	catch (const Exception &e)
 	{
@@ -356,15 +452,19 @@ runRMXPScripts(mrb_state *mrb, mrbc_context *ctx)
 	if (!mrb_array_p(scriptArray))
 	{
 		showError(std::string("Failed to read script data") + readError);
-		mrb_close(scriptMrb);
 		return;
 	}
 
 	int scriptCount = RARRAY_LEN(scriptArray);
 
+	ScriptCache cache(shState->rtData().config, "mruby " MRUBY_VERSION, scriptCount);
+
 	std::string decodeBuffer;
 	decodeBuffer.resize(0x1000);
 
+	/* Each script is compiled (or taken from the cache) right
+	 * before it runs, so one that fails to compile still lets
+	 * all scripts before it run */
 	for (int i = 0; i < scriptCount; ++i)
 	{
 		mrb_value script = mrb_ary_entry(scriptArray, i);
@@ -373,64 +473,54 @@ runRMXPScripts(mrb_state *mrb, mrbc_context *ctx)
 		mrb_value scriptName   = mrb_ary_entry(script, 1);
 		mrb_value scriptString = mrb_ary_entry(script, 2);
 
-		(void) scriptChksum;
-
-		int result = Z_OK;
-		unsigned long bufferLen;
-
-		while (true)
-		{
-			unsigned char *bufferPtr =
-			        reinterpret_cast<unsigned char*>(const_cast<char*>(decodeBuffer.c_str()));
-			unsigned char *sourcePtr =
-			        reinterpret_cast<unsigned char*>(RSTRING_PTR(scriptString));
-
-			bufferLen = decodeBuffer.length();
-
-			result = uncompress(bufferPtr, &bufferLen,
-			                    sourcePtr, RSTRING_LEN(scriptString));
+		const uint32_t chksum = mrb_fixnum_p(scriptChksum) ? mrb_fixnum(scriptChksum) : 0;
+		const uint32_t srcCrc = crc32(0, (const Bytef*) RSTRING_PTR(scriptString),
+		                              RSTRING_LEN(scriptString));
 
-			bufferPtr[bufferLen] = '\0';
+		mrb_irep *irep = 0;
 
-			if (result != Z_BUF_ERROR)
-				break;
+		if (const std::string *cached = cache.lookup(i, chksum, srcCrc))
+			irep = mrb_read_irep(mrb, (const uint8_t*) cached->data());
 
-			decodeBuffer.resize(decodeBuffer.size()*2);
-		}
-
-		if (result != Z_OK)
+		if (!irep)
 		{
-			static char buffer[256];
-			snprintf(buffer, sizeof(buffer), "Error decoding script %d: '%s'",
-			         i, RSTRING_PTR(scriptName));
-
-			showError(buffer);
-
-			break;
+			irep = decodeAndCompile(mrb, ctx, cache, i, chksum, srcCrc,
+			                        scriptName, scriptString, decodeBuffer);
+
+			if (!irep)
+			{
+				cache.flush();
+				return;
+			}
 		}
 
-		ctx->filename = RSTRING_PTR(scriptName);
-		ctx->lineno = 1;
+		/* The last script holds the main loop, which may
+		 * never return; whatever was compiled is saved now */
+		if (i == scriptCount - 1)
+			cache.flush();
 
 		int ai = mrb_gc_arena_save(mrb);
 
-		/* Execute code */
-		mrb_load_nstring_cxt(mrb, decodeBuffer.c_str(), bufferLen, ctx);
+		/* Execute code; the proc keeps its own irep reference */
+		RProc *proc = mrb_proc_new(mrb, irep);
+		mrb_irep_decref(mrb, irep);
+		mrb_top_run(mrb, proc, mrb_top_self(mrb), 0);
 
 		mrb_gc_arena_restore(mrb, ai);
 
 		if (mrb->exc) {
-			printf("%s - err\n", ctx->filename);
+			printf("%s - err\n", RSTRING_PTR(scriptName));
+			cache.flush();
 			return;
 		}
 	}
 
+	cache.flush();
+
 #ifdef __EMSCRIPTEN__
 	static_mrb = mrb;
 	emscripten_set_main_loop(main_update_loop, 0, true);
 #endif
-
-	mrb_close(scriptMrb);
 }
 
 static void mrbBindingExecute()
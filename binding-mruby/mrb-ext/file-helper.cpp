@@ -2,6 +2,12 @@
 #include "file-helper.h"
 #include <SDL_rwops.h>
 
+#include <mruby/string.h>
+
+#include "sharedstate.h"
+#include "filesystem.h"
+#include "exception.h"
+
 #ifdef __EMSCRIPTEN__
 #include "emscripten.hpp"
 #endif
@@ -36,17 +42,29 @@ char* SDL_rw_file_helper::read() {
         return res;
 }
 
-bool SDL_rw_file_helper::write(char * data) {
-        SDL_RWops *rw = SDL_RWFromFile(filename, "w");
-        if(rw != NULL) {
-		size_t len = SDL_strlen(data);
-		if (SDL_RWwrite(rw, data, 1, len) != len) {
-		        return false;
-		} else {
-		        return true;
-		}
-        	SDL_RWclose(rw);
-        	return true;
-        }
-        return false;
+mrb_value readFileString(mrb_state *mrb, const char *filename) {
+
+#ifdef __EMSCRIPTEN__
+	load_file_async_js(filename);
+#endif
+
+	SDL_RWops ops;
+	shState->fileSystem().openReadRaw(ops, filename);
+
+	const Sint64 size = SDL_RWsize(&ops);
+
+	if (size < 0) {
+		SDL_RWclose(&ops);
+		throw Exception(Exception::IOError, "%s: cannot determine size", filename);
+	}
+
+	mrb_value str = mrb_str_new(mrb, 0, size);
+	const size_t read = SDL_RWread(&ops, RSTRING_PTR(str), 1, size);
+
+	SDL_RWclose(&ops);
+
+	if (read != (size_t) size)
+		throw Exception(Exception::IOError, "%s: short read", filename);
+
+	return str;
 }
@@ -1,6 +1,11 @@
+#include <mruby.h>
+
 struct SDL_rw_file_helper {
     const char * filename;
     char * read();
     int length;
-    bool write(char * data);
-};
\ No newline at end of file
+};
+/* Reads a whole file through the FileSystem (and thus from
+ * encrypted archives too) straight into a new string, which
+ * the GC takes care of. Throws on failure */
+mrb_value readFileString(mrb_state *mrb, const char *filename);
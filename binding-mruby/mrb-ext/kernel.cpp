@@ -30,11 +30,14 @@
 
 #include "../binding-util.h"
 #include "marshal.h"
+#include "marshal-load.h"
 #include "file-helper.h"
 #include "sharedstate.h"
 #include "eventthread.h"
 #include "exception.h"
 #include "filesystem.h"
+#include "prefetcher.h"
+#include "savewriter.h"
 #include "binding.h"
 
 #ifdef __EMSCRIPTEN__
@@ -48,13 +51,16 @@ MRB_FUNCTION(kernelLoadData)
 	const char *filename;
 	mrb_get_args(mrb, "z", &filename);
 
-	mrb_value obj;
+	mrb_value obj = mrb_nil_value();
 	try {
-		SDL_rw_file_helper fileHelper;
-		fileHelper.filename = filename;
-		char * contents = fileHelper.read();
-		mrb_value rawdata = mrb_str_new_static(mrb, contents, fileHelper.length);
-		obj = mrb_marshal_load(mrb, rawdata);
+		/* Pending saves first, in case this is one of them */
+		shState->saveWriter().flush();
+		shState->prefetcher().demand(filename);
+
+		mrb_value rawdata = readFileString(mrb, filename);
+		obj = marshalLoad(mrb, rawdata);
+
+		shState->prefetcher().dataLoaded(filename);
 	}
 	catch (const Exception &e)
 	{
@@ -74,9 +80,9 @@ MRB_FUNCTION(kernelSaveData)
 	try {
 		mrb_value dumped = mrb_nil_value();
 		mrb_marshal_dump(mrb, obj, dumped);
-		SDL_rw_file_helper fileHelper;
-		fileHelper.filename = filename;
-		fileHelper.write(RSTRING_PTR(dumped));
+
+		std::string data(RSTRING_PTR(dumped), RSTRING_LEN(dumped));
+		shState->saveWriter().write(filename, data);
 	}
 	catch (const Exception &e)
 	{
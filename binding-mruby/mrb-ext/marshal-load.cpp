@@ -0,0 +1,497 @@
+/*
+** marshal-load.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "marshal-load.h"
+#include "marshal.h"
+
+#include <mruby/array.h>
+#include <mruby/class.h>
+#include <mruby/data.h>
+#include <mruby/hash.h>
+#include <mruby/numeric.h>
+#include <mruby/string.h>
+#include <mruby/variable.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../binding-util.h"
+#include "../binding-types.h"
+#include "sharedstate.h"
+#include "eventthread.h"
+#include "table.h"
+#include "etc.h"
+
+/* Thrown for anything left to the generic loader, including
+ * damaged streams (so it can raise the proper error). An mruby
+ * exception (raised by 'default=' or a const lookup) longjmps
+ * straight through the reader, so it must not own anything with
+ * a destructor; all its state lives in mruby objects instead */
+struct Unsupported {};
+
+struct MarshalReader
+{
+	struct Symbol
+	{
+		/* Points into the stream */
+		const char *name;
+		mrb_int len;
+		mrb_sym sym;
+
+		/* Resolved on first use as a class name */
+		RClass *klass;
+	};
+
+	mrb_state *mrb;
+	const uint8_t *p;
+	const uint8_t *end;
+
+	/* Everything '@' can link back to; also keeps all
+	 * objects built so far reachable for the GC */
+	mrb_value objects;
+
+	/* Packed Symbol structs; an mruby string so the GC
+	 * frees it however loading ends */
+	mrb_value symbols;
+
+	RClass *tableClass;
+	RClass *colorClass;
+	RClass *toneClass;
+
+	MarshalReader(mrb_state *mrb, mrb_value data)
+	    : mrb(mrb),
+	      p(reinterpret_cast<const uint8_t*>(RSTRING_PTR(data))),
+	      end(p + RSTRING_LEN(data)),
+	      objects(mrb_ary_new(mrb)),
+	      symbols(mrb_str_new(mrb, 0, 0))
+	{
+		tableClass = mrb_class_get(mrb, "Table");
+		colorClass = mrb_class_get(mrb, "Color");
+		toneClass = mrb_class_get(mrb, "Tone");
+	}
+
+	uint8_t readByte()
+	{
+		if (p >= end)
+			throw Unsupported();
+
+		return *p++;
+	}
+
+	long readInt()
+	{
+		const int8_t c = (int8_t) readByte();
+
+		if (c == 0)
+			return 0;
+
+		if (c > 4)
+			return c - 5;
+
+		if (c < -4)
+			return c + 5;
+
+		long x = c > 0 ? 0 : -1;
+
+		for (int i = 0; i < (c > 0 ? c : -c); ++i)
+		{
+			x &= ~(0xFFL << (8*i));
+			x |= (long) readByte() << (8*i);
+		}
+
+		return x;
+	}
+
+	/* Element counts can't exceed what's left of the stream */
+	long readCount()
+	{
+		const long n = readInt();
+
+		if (n < 0 || n > end - p)
+			throw Unsupported();
+
+		return n;
+	}
+
+	const char *readBytes(mrb_int &len)
+	{
+		len = readCount();
+
+		const char *data = reinterpret_cast<const char*>(p);
+		p += len;
+
+		return data;
+	}
+
+	mrb_value entry(mrb_value obj)
+	{
+		mrb_ary_push(mrb, objects, obj);
+
+		return obj;
+	}
+
+	size_t symbolCount()
+	{
+		return RSTRING_LEN(symbols) / sizeof(Symbol);
+	}
+
+	/* Only valid until the next symbol is added */
+	Symbol &symbolAt(size_t idx)
+	{
+		return reinterpret_cast<Symbol*>(RSTRING_PTR(symbols))[idx];
+	}
+
+	/* Index into 'symbols' */
+	size_t symbol()
+	{
+		switch (readByte())
+		{
+		case ':' :
+		{
+			Symbol s;
+			s.name = readBytes(s.len);
+			s.sym = mrb_intern(mrb, s.name, s.len);
+			s.klass = 0;
+
+			mrb_str_cat(mrb, symbols, reinterpret_cast<const char*>(&s), sizeof(s));
+
+			return symbolCount() - 1;
+		}
+
+		case ';' :
+		{
+			const long idx = readInt();
+
+			if (idx < 0 || idx >= (long) symbolCount())
+				throw Unsupported();
+
+			return idx;
+		}
+
+		case 'I' :
+		{
+			/* Symbol with encoding */
+			const size_t idx = symbol();
+			skipIvars();
+
+			return idx;
+		}
+
+		default :
+			throw Unsupported();
+		}
+	}
+
+	bool isEncodingIvar(size_t idx)
+	{
+		const Symbol &s = symbolAt(idx);
+
+		return (s.len == 1 && s.name[0] == 'E') ||
+		       (s.len == 8 && memcmp(s.name, "encoding", 8) == 0);
+	}
+
+	/* mruby strings don't carry an encoding */
+	void skipIvars()
+	{
+		for (long n = readCount(); n > 0; --n)
+		{
+			const size_t idx = symbol();
+			value();
+
+			if (!isEncodingIvar(idx))
+				throw Unsupported();
+		}
+	}
+
+	RClass *classFor(size_t idx)
+	{
+		Symbol &s = symbolAt(idx);
+
+		if (s.klass)
+			return s.klass;
+
+		RClass *klass = mrb->object_class;
+		const char *name = s.name;
+		const char *nameEnd = s.name + s.len;
+
+		while (true)
+		{
+			const char *segEnd = name;
+
+			while (segEnd < nameEnd && !(segEnd[0] == ':' && segEnd+1 < nameEnd && segEnd[1] == ':'))
+				++segEnd;
+
+			const mrb_sym seg = mrb_intern(mrb, name, segEnd - name);
+			const mrb_value mod = mrb_obj_value(klass);
+
+			if (!mrb_const_defined(mrb, mod, seg))
+				throw Unsupported();
+
+			const mrb_value c = mrb_const_get(mrb, mod, seg);
+
+			if (mrb_type(c) != MRB_TT_CLASS && mrb_type(c) != MRB_TT_MODULE)
+				throw Unsupported();
+
+			klass = mrb_class_ptr(c);
+
+			if (segEnd == nameEnd)
+				break;
+
+			name = segEnd + 2;
+		}
+
+		if (klass->tt != MRB_TT_CLASS)
+			throw Unsupported();
+
+		return s.klass = klass;
+	}
+
+	mrb_value string()
+	{
+		mrb_int len;
+		const char *data = readBytes(len);
+
+		return entry(mrb_str_new(mrb, data, len));
+	}
+
+	mrb_value floatValue()
+	{
+		mrb_int len;
+		const char *data = readBytes(len);
+
+		/* Ruby 1.8 appended mantissa bytes after a NUL */
+		char buf[64];
+		const size_t n = len < (mrb_int) sizeof(buf) ? len : sizeof(buf) - 1;
+		memcpy(buf, data, n);
+		buf[n] = '\0';
+
+		return entry(mrb_float_value(mrb, strtod(buf, 0)));
+	}
+
+	mrb_value array()
+	{
+		const long n = readCount();
+		mrb_value ary = entry(mrb_ary_new_capa(mrb, n));
+
+		for (long i = 0; i < n; ++i)
+			mrb_ary_push(mrb, ary, value());
+
+		return ary;
+	}
+
+	mrb_value hash(bool withDefault)
+	{
+		const long n = readCount();
+		mrb_value hash = entry(mrb_hash_new_capa(mrb, n));
+
+		for (long i = 0; i < n; ++i)
+		{
+			mrb_value key = value();
+			mrb_hash_set(mrb, hash, key, value());
+		}
+
+		if (withDefault)
+		{
+			mrb_value def = value();
+			mrb_funcall(mrb, hash, "default=", 1, def);
+		}
+
+		return hash;
+	}
+
+	mrb_value object()
+	{
+		RClass *klass = classFor(symbol());
+		const int tt = MRB_INSTANCE_TT(klass);
+
+		if (tt != 0 && tt != MRB_TT_OBJECT)
+			throw Unsupported();
+
+		RObject *obj = (RObject*) mrb_obj_alloc(mrb, MRB_TT_OBJECT, klass);
+		mrb_value result = entry(mrb_obj_value(obj));
+
+		for (long n = readCount(); n > 0; --n)
+		{
+			const mrb_sym ivar = symbolAt(symbol()).sym;
+			mrb_obj_iv_set(mrb, obj, ivar, value());
+		}
+
+		return result;
+	}
+
+	template<class C>
+	mrb_value deserialize(RClass *klass, const char *data, mrb_int len,
+	                      const mrb_data_type &type)
+	{
+		C *c = C::deserialize(data, len);
+
+		return mrb_obj_value(mrb_data_object_alloc(mrb, klass, c, &type));
+	}
+
+	/* Only the types RPG data uses; their _load is bypassed */
+	mrb_value userType(bool withIvars)
+	{
+		RClass *klass = classFor(symbol());
+
+		mrb_int len;
+		const char *data = readBytes(len);
+
+		if (withIvars)
+			skipIvars();
+
+		if (klass == tableClass)
+			return entry(deserialize<Table>(klass, data, len, TableType));
+
+		if (klass == colorClass)
+			return entry(deserialize<Color>(klass, data, len, ColorType));
+
+		if (klass == toneClass)
+			return entry(deserialize<Tone>(klass, data, len, ToneType));
+
+		throw Unsupported();
+	}
+
+	mrb_value ivarWrapped()
+	{
+		switch (readByte())
+		{
+		case '"' :
+		{
+			mrb_value str = string();
+			skipIvars();
+
+			return str;
+		}
+
+		case 'u' :
+			return userType(true);
+
+		case ':' :
+			p -= 2;
+			return mrb_symbol_value(symbolAt(symbol()).sym);
+
+		default :
+			throw Unsupported();
+		}
+	}
+
+	mrb_value readValue()
+	{
+		const uint8_t type = readByte();
+
+		switch (type)
+		{
+		case '0' :
+			return mrb_nil_value();
+
+		case 'T' :
+			return mrb_true_value();
+
+		case 'F' :
+			return mrb_false_value();
+
+		case 'i' :
+		{
+			const long x = readInt();
+
+			if (!FIXABLE(x))
+				throw Unsupported();
+
+			return mrb_fixnum_value(x);
+		}
+
+		case ':' :
+		case ';' :
+			--p;
+			return mrb_symbol_value(symbolAt(symbol()).sym);
+
+		case '@' :
+		{
+			const long idx = readInt();
+
+			if (idx < 0 || idx >= RARRAY_LEN(objects))
+				throw Unsupported();
+
+			return mrb_ary_ref(mrb, objects, idx);
+		}
+
+		case '"' :
+			return string();
+
+		case 'f' :
+			return floatValue();
+
+		case '[' :
+			return array();
+
+		case '{' :
+		case '}' :
+			return hash(type == '}');
+
+		case 'o' :
+			return object();
+
+		case 'u' :
+			return userType(false);
+
+		case 'I' :
+			return ivarWrapped();
+
+		default :
+			throw Unsupported();
+		}
+	}
+
+	/* Whatever is returned is either immediate
+	 * or in 'objects', so the arena can be reset */
+	mrb_value value()
+	{
+		const int ai = mrb_gc_arena_save(mrb);
+		mrb_value v = readValue();
+		mrb_gc_arena_restore(mrb, ai);
+
+		return v;
+	}
+
+	mrb_value load()
+	{
+		if (readByte() != 4 || readByte() != 8)
+			throw Unsupported();
+
+		return value();
+	}
+};
+
+mrb_value marshalLoad(mrb_state *mrb, mrb_value data)
+{
+	if (shState->rtData().config.nativeMarshal)
+	{
+		try
+		{
+			MarshalReader reader(mrb, data);
+
+			return reader.load();
+		}
+		catch (const Unsupported &)
+		{}
+	}
+
+	return mrb_marshal_load(mrb, data);
+}
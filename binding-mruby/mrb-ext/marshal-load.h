@@ -0,0 +1,31 @@
+/*
+** marshal-load.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef MARSHALLOAD_H
+#define MARSHALLOAD_H
+
+#include <mruby.h>
+
+/* Marshal.load for game data. Streams made of plain objects
+ * (RPG::*), arrays, hashes, strings, numbers and the Table,
+ * Color and Tone user types are built natively; anything else
+ * is handed to the generic mrb_marshal_load() */
+mrb_value marshalLoad(mrb_state *mrb, mrb_value data);
+
+#endif // MARSHALLOAD_H
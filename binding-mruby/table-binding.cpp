@@ -20,10 +20,13 @@
 */
 
 #include "table.h"
+#include "etc.h"
 #include "binding-util.h"
 #include "binding-types.h"
 #include "serializable-binding.h"
 
+#include <mruby/string.h>
+
 DEF_TYPE(Table);
 
 MRB_METHOD(tableInitialize)
@@ -140,6 +143,78 @@ MRB_METHOD(tableSetAt)
 	return mrb_fixnum_value(value);
 }
 
+MRB_METHOD(tableFill)
+{
+	Table *t = getPrivateData<Table>(mrb, self);
+
+	mrb_int value, z = 0;
+	mrb_value rectObj;
+
+	mrb_get_args(mrb, "io|i", &value, &rectObj, &z);
+
+	Rect *rect = getPrivateDataCheck<Rect>(mrb, rectObj, RectType);
+
+	t->fill(value, rect->toIntRect(), z);
+
+	return self;
+}
+
+MRB_METHOD(tableBlit)
+{
+	Table *t = getPrivateData<Table>(mrb, self);
+
+	mrb_value srcObj, rectObj;
+	mrb_int dx, dy;
+
+	mrb_get_args(mrb, "ooii", &srcObj, &rectObj, &dx, &dy);
+
+	Table *src = getPrivateDataCheck<Table>(mrb, srcObj, TableType);
+	Rect *rect = getPrivateDataCheck<Rect>(mrb, rectObj, RectType);
+
+	t->blit(*src, rect->toIntRect(), dx, dy);
+
+	return self;
+}
+
+MRB_METHOD(tableReplaceAll)
+{
+	Table *t = getPrivateData<Table>(mrb, self);
+
+	mrb_int from, to;
+
+	mrb_get_args(mrb, "ii", &from, &to);
+
+	return mrb_fixnum_value(t->replaceAll(from, to));
+}
+
+MRB_METHOD(tableToS)
+{
+	Table *t = getPrivateData<Table>(mrb, self);
+
+	mrb_value data = mrb_str_new(mrb, 0, t->rawSize());
+	t->readRaw(RSTRING_PTR(data));
+
+	return data;
+}
+
+MRB_METHOD(tableFromS)
+{
+	Table *t = getPrivateData<Table>(mrb, self);
+
+	char *data;
+	mrb_int dataLen;
+
+	mrb_get_args(mrb, "s", &data, &dataLen);
+
+	if (dataLen != t->rawSize())
+		mrb_raisef(mrb, E_ARGUMENT_ERROR, "Table data size mismatch (%S bytes, expected %S)",
+		           mrb_fixnum_value(dataLen), mrb_fixnum_value(t->rawSize()));
+
+	t->writeRaw(data);
+
+	return self;
+}
+
 MARSH_LOAD_FUN(Table)
 INITCOPY_FUN(Table)
 
@@ -161,5 +236,11 @@ tableBindingInit(mrb_state *mrb)
 	mrb_define_method(mrb, klass, "[]",         tableGetAt,      MRB_ARGS_REQ(1) | MRB_ARGS_OPT(2));
 	mrb_define_method(mrb, klass, "[]=",        tableSetAt,      MRB_ARGS_REQ(2) | MRB_ARGS_OPT(2));
 
+	mrb_define_method(mrb, klass, "fill",        tableFill,       MRB_ARGS_REQ(2) | MRB_ARGS_OPT(1));
+	mrb_define_method(mrb, klass, "blit",        tableBlit,       MRB_ARGS_REQ(4)                  );
+	mrb_define_method(mrb, klass, "replace_all", tableReplaceAll, MRB_ARGS_REQ(2)                  );
+	mrb_define_method(mrb, klass, "to_s",        tableToS,        MRB_ARGS_NONE()                  );
+	mrb_define_method(mrb, klass, "from_s",      tableFromS,      MRB_ARGS_REQ(1)                  );
+
 	mrb_define_method(mrb, klass, "inspect", inspectObject, MRB_ARGS_NONE());
 }
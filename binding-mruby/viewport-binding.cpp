@@ -75,6 +75,17 @@ DEF_PROP_OBJ_VAL(Viewport, Tone,  Tone,  CStone)
 DEF_PROP_I(Viewport, OX)
 DEF_PROP_I(Viewport, OY)
 
+DEF_PROP_B(Viewport, Cache)
+
+MRB_METHOD(viewportRefresh)
+{
+	Viewport *v = getPrivateData<Viewport>(mrb, self);
+
+	GUARD_EXC( v->refresh(); )
+
+	return mrb_nil_value();
+}
+
 
 void
 viewportBindingInit(mrb_state *mrb)
@@ -92,6 +103,9 @@ viewportBindingInit(mrb_state *mrb)
 	INIT_PROP_BIND( Viewport, OY,    "oy"    );
 	INIT_PROP_BIND( Viewport, Color, "color" );
 	INIT_PROP_BIND( Viewport, Tone,  "tone"  );
+	INIT_PROP_BIND( Viewport, Cache, "cache" );
+
+	mrb_define_method(mrb, klass, "refresh", viewportRefresh, MRB_ARGS_NONE());
 
 	mrb_define_method(mrb, klass, "inspect", inspectObject, MRB_ARGS_NONE());
 }
@@ -97,7 +97,12 @@ echo "Finished building MKXP"
 mkdir -p build
 cp -R mkxp.html mkxp.wasm mkxp.js extra/*.webmanifest extra/js build/
 
+# Build the native asset manifest builder
+cmake -S extra/mkxp-pack -B build-pack -DCMAKE_BUILD_TYPE=Release
+cmake --build build-pack -j"$(nproc)"
+
 # Copy scripts needed for runtime processing
+cp build-pack/mkxp-pack build-pack/mkxp-preload build/
 cp extra/rgss.rb build/
 cp extra/make_mapping.sh build/
 cp extra/dump.sh build/
@@ -0,0 +1,41 @@
+# Times load_data over a game's map files.
+#
+# Run it from the game folder through mkxp.conf:
+#
+#   customScript=/path/to/bench_marshal.rb
+#
+# once with nativeMarshal=true and once with nativeMarshal=false.
+
+ROUNDS = 5
+
+ext = ['rxdata', 'rvdata', 'rvdata2'].find do |e|
+  begin
+    load_data("Data/MapInfos.#{e}")
+    true
+  rescue
+    false
+  end
+end
+
+if ext.nil?
+  print "No MapInfos found in Data/"
+  exit
+end
+
+maps = []
+(1..999).each do |id|
+  name = "Data/Map%03d.%s" % [id, ext]
+
+  begin
+    load_data(name)
+    maps << name
+  rescue
+  end
+end
+
+start = Time.now
+ROUNDS.times { maps.each { |m| load_data(m) } }
+ms = (Time.now - start) * 1000.0
+
+print "#{maps.size} maps x #{ROUNDS} rounds: #{ms.round} ms " +
+      "(#{(ms / (maps.size * ROUNDS)).round(2)} ms per map)"
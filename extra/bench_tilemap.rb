@@ -0,0 +1,77 @@
+# Times RGSS1 tilemap scrolling over a map too big to keep all
+# of its tile chunks built at once.
+#
+# Run it from an RGSS1 game folder through mkxp.conf, with the
+# frame limiter out of the way:
+#
+#   customScript=/path/to/bench_tilemap.rb
+#   fixedFramerate=-1
+#   frameSkip=false
+#   vsync=false
+#   syncToRefreshrate=false
+#
+# The map is swept screen by screen down and back up again, so the
+# way back revisits chunks built on the way down. Every frame goes
+# through Graphics.update; the same sweep without any tilemap is
+# timed first and subtracted, leaving the tilemap's own cost.
+
+ROUNDS = 3
+SIZE = 400
+LAYERS = 3
+
+w = Graphics.width
+h = Graphics.height
+
+# One screen per frame, down the map and back up
+positions = []
+
+(0...SIZE * 32).step(h) do |oy|
+  (0...SIZE * 32).step(w) { |ox| positions << [ox, oy] }
+end
+
+positions += positions.reverse
+
+def sweep(positions)
+  start = Time.now
+
+  ROUNDS.times do
+    positions.each do |ox, oy|
+      yield ox, oy
+      Graphics.update
+    end
+  end
+
+  Time.now - start
+end
+
+base = sweep(positions) {}
+
+tilemap = Tilemap.new
+tilemap.tileset = Bitmap.new(256, 32 * 64)
+7.times { |i| tilemap.autotiles[i] = Bitmap.new(96, 128) }
+
+# Autotiles everywhere on the ground layer, tileset tiles
+# on the upper ones, so every chunk is as big as it gets
+data = Table.new(SIZE, SIZE, LAYERS)
+
+SIZE.times do |y|
+  SIZE.times do |x|
+    data[x, y, 0] = 48 + ((x / 4 + y / 4) % 7) * 48 + (x * 7 + y * 13) % 48
+    data[x, y, 1] = 384 + (x * 3 + y) % (8 * 64)
+    data[x, y, 2] = 384 + (x + y * 5) % (8 * 64)
+  end
+end
+
+tilemap.priorities = Table.new(384 + 8 * 64)
+tilemap.map_data = data
+
+shown = sweep(positions) do |ox, oy|
+  tilemap.ox = ox
+  tilemap.oy = oy
+end
+
+frames = positions.size * ROUNDS
+ms = (shown - base) * 1000.0
+
+print "#{frames} frames, tilemap #{ms.round} ms " +
+      "(#{(ms / frames).round(3)} ms per frame)"
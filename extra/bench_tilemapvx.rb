@@ -0,0 +1,84 @@
+# Times VX tilemap tile reading over a 200x200 autotile map.
+#
+# Run it from an RGSS2 or RGSS3 game folder through mkxp.conf,
+# with the frame limiter out of the way:
+#
+#   customScript=/path/to/bench_tilemapvx.rb
+#   fixedFramerate=-1
+#   frameSkip=false
+#   vsync=false
+#   syncToRefreshrate=false
+#
+# Each round assigns a fresh copy of the map data (assigning the
+# same Table again keeps the built tile chunks), then scrolls over
+# the whole map so every tile is read once. Every frame goes through
+# Graphics.update; the same scroll without any tilemap is timed
+# first and subtracted, leaving the tilemap's own cost.
+
+ROUNDS = 5
+SIZE = 200
+LAYERS = 3
+
+w = Graphics.width
+h = Graphics.height
+
+positions = []
+
+(0...SIZE * 32).step(h) do |oy|
+  (0...SIZE * 32).step(w) { |ox| positions << [ox, oy] }
+end
+
+def scroll(positions)
+  positions.each do |ox, oy|
+    yield ox, oy
+    Graphics.update
+  end
+end
+
+start = Time.now
+ROUNDS.times { scroll(positions) {} }
+base = Time.now - start
+
+tilemap = Tilemap.new
+
+sizes = [[512, 384], [512, 384], [512, 256], [512, 480], [256, 512],
+         [512, 512], [512, 512], [512, 512], [512, 512]]
+sizes.each_with_index { |s, i| tilemap.bitmaps[i] = Bitmap.new(*s) }
+
+# Regular (A1, A2), wall (A3) and mixed (A4) autotiles on the ground
+# layer, table autotiles on every third tile of the second layer and
+# plain B tiles on the third
+kinds = [0x0800, 0x0B00, 0x1100, 0x1700]
+
+data = Table.new(SIZE, SIZE, LAYERS)
+
+SIZE.times do |y|
+  SIZE.times do |x|
+    pattern = (x * 7 + y * 13) % 0x30
+
+    data[x, y, 0] = kinds[(x / 8 + y / 8) % 4] + pattern
+    data[x, y, 1] = 0x0B00 + 7 * 0x30 + pattern if (x + y) % 3 == 0
+    data[x, y, 2] = (x * 3 + y) % 0x100 if (x * y) % 5 == 0
+  end
+end
+
+tilemap.flags = Table.new(0x2000)
+
+copies = Array.new(ROUNDS) { data.clone }
+
+start = Time.now
+
+copies.each do |copy|
+  tilemap.map_data = copy
+
+  scroll(positions) do |ox, oy|
+    tilemap.ox = ox
+    tilemap.oy = oy
+  end
+end
+
+us = (Time.now - start - base) * 1000000.0
+tiles = SIZE * SIZE * LAYERS * ROUNDS
+
+print "#{tiles} tiles in #{(us / 1000.0).round} ms " +
+      "(#{(tiles / us).round(2)} tiles per microsecond)"
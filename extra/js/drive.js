@@ -2,6 +2,11 @@
 var generationCanvas = document.createElement('canvas')
 window.fileAsyncCache = {};
 
+// Engine side prefetcher state (see src/prefetcher.cpp)
+window.prefetchPending = {};
+window.prefetchStatus = {};
+window.prefetchManifests = {};
+
 window.getMappingKey = function(file) {
     return file.toLowerCase().replace(new RegExp("\\.[^/.]+$"), "")
 }
@@ -17,6 +22,12 @@ window.loadFileAsync = function(fullPath, bitmap, callback) {
     // Check if already loaded
     if (window.fileAsyncCache.hasOwnProperty(mappingKey)) return callback();
 
+    // Wait for a prefetch in flight, loading normally if it fails
+    if (window.prefetchPending.hasOwnProperty(mappingKey)) {
+        window.prefetchPending[mappingKey].push(() => window.loadFileAsync(fullPath, bitmap, callback));
+        return;
+    }
+
     // Show spinner
     if (!bitmap && window.setBusy) window.setBusy();
 
@@ -184,20 +195,46 @@ function preloadList(jsonArray) {
     });
 }
 
-window.fileLoadedAsync = function(file) {
-    document.title = wTitle;
+// Called by the engine's prefetcher, which polls prefetchStatus
+// for the number of bytes fetched (0 if skipped or failed)
+window.prefetchFileAsync = function(fullPath) {
+    const mappingKey = getMappingKey(fullPath);
+    const mappingValue = mapping[mappingKey];
+
+    if (!mappingValue || mappingValue.endsWith("h=") ||
+        window.fileAsyncCache.hasOwnProperty(mappingKey) ||
+        window.prefetchPending.hasOwnProperty(mappingKey)) {
+        window.prefetchStatus[fullPath] = 0;
+        return;
+    }
+
+    window.prefetchPending[mappingKey] = [];
 
-    if (!(/.*Map.*rxdata/i.test(file))) return;
+    const finish = (size) => {
+        const waiting = window.prefetchPending[mappingKey];
+        delete window.prefetchPending[mappingKey];
+        window.prefetchStatus[fullPath] = size;
+        waiting.forEach((cb) => cb());
+    };
+
+    // Get path and filename
+    const path = "/game/" + mappingValue.substring(0, mappingValue.lastIndexOf("/"));
+    const filename = mappingValue.substring(mappingValue.lastIndexOf("/") + 1).split("?")[0];
 
-    fetch('preload/' + file + '.json')
-        .then(function(response) {
-            return response.json();
-        })
-        .then(function(jsonResponse) {
-            setTimeout(() => {
-                preloadList(jsonResponse);
-            }, 200);
+    getLazyAsset("gameasync/" + mappingValue, filename, (data) => {
+        if (!data) return finish(0);
+
+        FS.createPreloadedFile(path, filename, new Uint8Array(data), true, true, function() {
+            window.fileAsyncCache[mappingKey] = 1;
+            finish(data.byteLength);
+        }, () => finish(0), false, false, () => {
+            try { FS.unlink(path + "/" + filename); } catch (err) {}
         });
+    }, true);
+};
+
+window.fileLoadedAsync = function(file) {
+    document.title = wTitle;
 };
 
 var activeStreams = [];
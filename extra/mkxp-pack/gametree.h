@@ -0,0 +1,108 @@
+/*
+** gametree.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef GAMETREE_H
+#define GAMETREE_H
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct TreeEntry
+{
+	/* Relative to the game directory */
+	std::string path;
+	bool isFile;
+};
+
+static inline void walkDir(const std::string &dir, std::vector<TreeEntry> &out)
+{
+	DIR *d = opendir(dir.empty() ? "." : dir.c_str());
+
+	if (!d)
+		return;
+
+	std::vector<std::string> names;
+
+	while (dirent *e = readdir(d))
+		if (e->d_name[0] != '.')
+			names.push_back(e->d_name);
+
+	closedir(d);
+
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		TreeEntry entry;
+		entry.path = dir.empty() ? names[i] : dir + "/" + names[i];
+
+		struct stat st;
+		if (stat(entry.path.c_str(), &st) != 0)
+			continue;
+
+		entry.isFile = S_ISREG(st.st_mode);
+		out.push_back(entry);
+
+		if (S_ISDIR(st.st_mode))
+			walkDir(entry.path, out);
+	}
+}
+
+static inline bool pathLess(const TreeEntry &a, const TreeEntry &b)
+{
+	return a.path < b.path;
+}
+
+/* Collects everything bash's '**' glob would (no dot files), in
+ * its order under the C locale: full paths sorted bytewise, so
+ * "a-c" comes before "a/b". 'dir' is empty for the current directory */
+static inline void walkTree(const std::string &dir, std::vector<TreeEntry> &out)
+{
+	const size_t first = out.size();
+
+	walkDir(dir, out);
+
+	std::sort(out.begin() + first, out.end(), pathLess);
+}
+
+static inline bool readFile(const std::string &path, std::vector<uint8_t> &data)
+{
+	FILE *f = fopen(path.c_str(), "rb");
+
+	if (!f)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	data.resize(size > 0 ? size : 0);
+	bool ok = data.empty() || fread(&data[0], 1, data.size(), f) == data.size();
+
+	fclose(f);
+
+	return ok;
+}
+
+#endif // GAMETREE_H
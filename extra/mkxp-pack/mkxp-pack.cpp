@@ -0,0 +1,632 @@
+/*
+** mkxp-pack.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Native replacement for make_mapping.sh. Run inside the game
+ * directory; writes mapping.js (asset name -> versioned URL) and
+ * bitmap-map.js (asset name -> size and 64x64 thumbnail data URI)
+ * in the same format, processing files on all cores.
+ *
+ * With --bundle, additionally packs all files into Bundle/
+ * (format described in src/bundle.h) */
+
+#include "gametree.h"
+
+#include <SDL.h>
+#include <SDL_image.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+static const int thumbSize = 64;
+
+struct Entry
+{
+	std::string path;
+	bool isFile;
+
+	Entry(const TreeEntry &e)
+	    : path(e.path),
+	      isFile(e.isFile),
+	      hashValue(0),
+	      isImage(false),
+	      width(0), height(0)
+	{}
+
+	/* Results */
+	uint64_t hashValue;
+	std::string hash;
+	bool isImage;
+	int width, height;
+	std::string thumbURI;
+};
+
+/* XXH64; only used to version URLs, so any fast hash would do */
+static const uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t prime3 = 0x165667B19E3779F9ULL;
+static const uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+static inline uint64_t rotl(uint64_t v, int r)
+{
+	return (v << r) | (v >> (64 - r));
+}
+
+static inline uint64_t read64(const uint8_t *p)
+{
+	uint64_t v;
+	memcpy(&v, p, sizeof(v));
+	return SDL_SwapLE64(v);
+}
+
+static inline uint32_t read32(const uint8_t *p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return SDL_SwapLE32(v);
+}
+
+static inline uint64_t hashRound(uint64_t acc, uint64_t input)
+{
+	acc += input * prime2;
+	acc = rotl(acc, 31);
+	return acc * prime1;
+}
+
+static inline uint64_t hashMerge(uint64_t acc, uint64_t val)
+{
+	acc ^= hashRound(0, val);
+	return acc * prime1 + prime4;
+}
+
+static uint64_t hash64(const uint8_t *p, size_t len)
+{
+	const uint8_t *end = p + len;
+	uint64_t h;
+
+	if (len >= 32)
+	{
+		uint64_t v1 = prime1 + prime2;
+		uint64_t v2 = prime2;
+		uint64_t v3 = 0;
+		uint64_t v4 = -prime1;
+
+		for (; p + 32 <= end; p += 32)
+		{
+			v1 = hashRound(v1, read64(p));
+			v2 = hashRound(v2, read64(p+8));
+			v3 = hashRound(v3, read64(p+16));
+			v4 = hashRound(v4, read64(p+24));
+		}
+
+		h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+		h = hashMerge(h, v1);
+		h = hashMerge(h, v2);
+		h = hashMerge(h, v3);
+		h = hashMerge(h, v4);
+	}
+	else
+	{
+		h = prime5;
+	}
+
+	h += len;
+
+	for (; p + 8 <= end; p += 8)
+	{
+		h ^= hashRound(0, read64(p));
+		h = rotl(h, 27) * prime1 + prime4;
+	}
+
+	if (p + 4 <= end)
+	{
+		h ^= read32(p) * prime1;
+		h = rotl(h, 23) * prime2 + prime3;
+		p += 4;
+	}
+
+	for (; p < end; ++p)
+	{
+		h ^= *p * prime5;
+		h = rotl(h, 11) * prime1;
+	}
+
+	h ^= h >> 33;
+	h *= prime2;
+	h ^= h >> 29;
+	h *= prime3;
+	h ^= h >> 32;
+
+	return h;
+}
+
+/* Box filter downscale of RGBA8 pixels; every destination pixel is
+ * the alpha weighted average of the source pixels it covers. The
+ * inner loops are kept simple so the compiler can vectorize them */
+static void boxDownscale(const uint8_t *src, int sw, int sh, int pitch,
+                         uint8_t *dst, int dw, int dh)
+{
+	for (int dy = 0; dy < dh; ++dy)
+	{
+		const int y0 = dy * sh / dh;
+		const int y1 = std::max(y0 + 1, (dy + 1) * sh / dh);
+
+		for (int dx = 0; dx < dw; ++dx)
+		{
+			const int x0 = dx * sw / dw;
+			const int x1 = std::max(x0 + 1, (dx + 1) * sw / dw);
+
+			uint64_t r = 0, g = 0, b = 0, a = 0;
+
+			for (int y = y0; y < y1; ++y)
+			{
+				const uint8_t *px = src + y*pitch + x0*4;
+
+				for (int x = x0; x < x1; ++x, px += 4)
+				{
+					r += px[0] * px[3];
+					g += px[1] * px[3];
+					b += px[2] * px[3];
+					a += px[3];
+				}
+			}
+
+			uint8_t *out = dst + (dy*dw + dx)*4;
+			const uint64_t n = (uint64_t) (x1 - x0) * (y1 - y0);
+
+			if (a == 0)
+			{
+				out[0] = out[1] = out[2] = out[3] = 0;
+				continue;
+			}
+
+			out[0] = r / a;
+			out[1] = g / a;
+			out[2] = b / a;
+			out[3] = a / n;
+		}
+	}
+}
+
+static std::string base64(const uint8_t *data, size_t len)
+{
+	static const char table[] =
+		"ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+	std::string out;
+	out.reserve((len + 2) / 3 * 4);
+
+	for (size_t i = 0; i < len; i += 3)
+	{
+		uint32_t v = data[i] << 16;
+
+		if (i+1 < len)
+			v |= data[i+1] << 8;
+		if (i+2 < len)
+			v |= data[i+2];
+
+		out += table[(v >> 18) & 0x3F];
+		out += table[(v >> 12) & 0x3F];
+		out += (i+1 < len) ? table[(v >> 6) & 0x3F] : '=';
+		out += (i+2 < len) ? table[v & 0x3F] : '=';
+	}
+
+	return out;
+}
+
+/* Decodes the image, shrinks it to fit 64x64 (never enlarging,
+ * like ImageMagick's '64x64>') and encodes it as a PNG data URI */
+static bool makeThumbnail(const std::vector<uint8_t> &data, Entry &entry)
+{
+	SDL_RWops *in = SDL_RWFromConstMem(&data[0], data.size());
+	SDL_Surface *img = IMG_Load_RW(in, 1);
+
+	if (!img)
+		return false;
+
+	SDL_Surface *rgba = SDL_ConvertSurfaceFormat(img, SDL_PIXELFORMAT_ABGR8888, 0);
+	SDL_FreeSurface(img);
+
+	if (!rgba)
+		return false;
+
+	entry.width = rgba->w;
+	entry.height = rgba->h;
+
+	int tw = rgba->w, th = rgba->h;
+
+	if (tw > thumbSize || th > thumbSize)
+	{
+		double scale = std::min((double) thumbSize / tw, (double) thumbSize / th);
+		tw = std::max(1, (int) (tw * scale + 0.5));
+		th = std::max(1, (int) (th * scale + 0.5));
+	}
+
+	SDL_Surface *thumb = SDL_CreateRGBSurfaceWithFormat(0, tw, th, 32, SDL_PIXELFORMAT_ABGR8888);
+
+	if (!thumb)
+	{
+		SDL_FreeSurface(rgba);
+		return false;
+	}
+
+	SDL_LockSurface(rgba);
+	boxDownscale((const uint8_t*) rgba->pixels, rgba->w, rgba->h, rgba->pitch,
+	             (uint8_t*) thumb->pixels, tw, th);
+	SDL_UnlockSurface(rgba);
+	SDL_FreeSurface(rgba);
+
+	/* Even stored uncompressed, a 64x64 PNG fits in here */
+	std::vector<uint8_t> png(thumbSize*thumbSize*4 + thumbSize + 4096);
+	SDL_RWops *out = SDL_RWFromMem(&png[0], png.size());
+
+	bool ok = IMG_SavePNG_RW(thumb, out, 0) == 0;
+	size_t pngSize = SDL_RWtell(out);
+
+	SDL_RWclose(out);
+	SDL_FreeSurface(thumb);
+
+	if (!ok)
+		return false;
+
+	entry.thumbURI = "data:image/png;base64," + base64(&png[0], pngSize);
+
+	return true;
+}
+
+static void processEntry(Entry &entry)
+{
+	if (!entry.isFile)
+		return;
+
+	std::vector<uint8_t> data;
+
+	if (!readFile(entry.path, data))
+		return;
+
+	entry.hashValue = hash64(data.empty() ? 0 : &data[0], data.size());
+
+	char hex[17];
+	snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) entry.hashValue);
+	entry.hash = hex;
+
+	if (data.empty())
+		return;
+
+	entry.isImage = makeThumbnail(data, entry);
+}
+
+/* Asset name as make_mapping.sh derived it: last extension
+ * stripped off the whole path, lower cased */
+static std::string assetName(const std::string &path)
+{
+	std::string name = path.substr(0, path.rfind('.'));
+
+	for (size_t i = 0; i < name.size(); ++i)
+		if (name[i] >= 'A' && name[i] <= 'Z')
+			name[i] += 'a' - 'A';
+
+	return name;
+}
+
+static const char *bundleDir = "Bundle";
+
+/* Blobs are cut at this size to keep them cacheable on the web;
+ * bigger files get a blob to themselves */
+static const uint64_t bundleBlobSize = 32 << 20;
+
+static bool inBundleDir(const std::string &path)
+{
+	return path == bundleDir || path.compare(0, strlen(bundleDir) + 1,
+	                                         std::string(bundleDir) + "/") == 0;
+}
+
+/* Our own outputs aren't read by the engine */
+static bool excludeFromBundle(const std::string &path)
+{
+	return inBundleDir(path) || path.compare(0, 8, "preload/") == 0 ||
+	       path == "mapping.js" || path == "bitmap-map.js";
+}
+
+static std::string lowerCase(std::string str)
+{
+	for (size_t i = 0; i < str.size(); ++i)
+		if (str[i] >= 'A' && str[i] <= 'Z')
+			str[i] += 'a' - 'A';
+
+	return str;
+}
+
+static void putLE(std::string &out, uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+		out += (char) ((value >> (8*i)) & 0xFF);
+}
+
+struct BundleRecord
+{
+	std::string key;
+	unsigned int blob;
+	uint64_t offset;
+	uint64_t size;
+	uint64_t hash;
+
+	bool operator<(const BundleRecord &o) const
+	{
+		return key < o.key;
+	}
+};
+
+static std::string blobPath(unsigned int index)
+{
+	char name[32];
+	snprintf(name, sizeof(name), "/%u.mkxpd", index);
+
+	return bundleDir + std::string(name);
+}
+
+/* Appends the paths of all written files to 'written' */
+static bool writeBundle(const std::vector<Entry> &entries,
+                        std::vector<std::string> &written)
+{
+	mkdir(bundleDir, 0755);
+
+	std::vector<BundleRecord> records;
+	std::set<std::string> keys;
+
+	/* Content addressing: (hash, size) -> index into records */
+	std::map<std::pair<uint64_t, uint64_t>, size_t> stored;
+
+	FILE *blob = 0;
+	unsigned int blobCount = 0;
+	uint64_t blobOffset = 0;
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		const Entry &e = entries[i];
+
+		if (!e.isFile || excludeFromBundle(e.path))
+			continue;
+
+		BundleRecord rec;
+		rec.key = lowerCase(e.path);
+
+		/* Only the first of several case variants is reachable anyway */
+		if (!keys.insert(rec.key).second)
+			continue;
+
+		std::vector<uint8_t> data;
+
+		if (!readFile(e.path, data))
+			continue;
+
+		rec.size = data.size();
+		rec.hash = e.hashValue;
+
+		const std::pair<uint64_t, uint64_t> content(rec.hash, rec.size);
+		std::map<std::pair<uint64_t, uint64_t>, size_t>::const_iterator dup =
+			stored.find(content);
+
+		if (dup != stored.end())
+		{
+			rec.blob = records[dup->second].blob;
+			rec.offset = records[dup->second].offset;
+			records.push_back(rec);
+			continue;
+		}
+
+		if (!blob || (blobOffset > 0 && blobOffset + rec.size > bundleBlobSize))
+		{
+			if (blob)
+				fclose(blob);
+
+			written.push_back(blobPath(blobCount++));
+			blob = fopen(written.back().c_str(), "wb");
+			blobOffset = 0;
+
+			if (!blob)
+				return false;
+		}
+
+		if (!data.empty() && fwrite(&data[0], 1, data.size(), blob) != data.size())
+		{
+			fclose(blob);
+			return false;
+		}
+
+		rec.blob = blobCount - 1;
+		rec.offset = blobOffset;
+		blobOffset += rec.size;
+
+		stored[content] = records.size();
+		records.push_back(rec);
+	}
+
+	if (blob)
+		fclose(blob);
+
+	std::sort(records.begin(), records.end());
+
+	std::string index = "MKXPBNDL";
+	putLE(index, 1, 4);
+	putLE(index, blobCount, 4);
+	putLE(index, records.size(), 4);
+
+	for (size_t i = 0; i < records.size(); ++i)
+	{
+		const BundleRecord &rec = records[i];
+
+		putLE(index, rec.key.size(), 2);
+		index += rec.key;
+		putLE(index, rec.blob, 2);
+		putLE(index, rec.offset, 8);
+		putLE(index, rec.size, 8);
+		putLE(index, rec.hash, 8);
+	}
+
+	written.insert(written.begin(), std::string(bundleDir) + "/index.mkxpb");
+
+	FILE *f = fopen(written.front().c_str(), "wb");
+
+	if (!f)
+		return false;
+
+	bool ok = fwrite(index.data(), 1, index.size(), f) == index.size();
+	fclose(f);
+
+	printf("Bundled %u files into %u blobs\n", (unsigned) records.size(), blobCount);
+
+	return ok;
+}
+
+static std::string jsString(const std::string &str)
+{
+	std::string out = "\"";
+
+	for (size_t i = 0; i < str.size(); ++i)
+	{
+		if (str[i] == '"' || str[i] == '\\')
+			out += '\\';
+
+		out += str[i];
+	}
+
+	return out + "\"";
+}
+
+int main(int argc, char *argv[])
+{
+	const bool bundle = argc > 1 && strcmp(argv[1], "--bundle") == 0;
+
+	if (SDL_Init(0) != 0 || !IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG))
+	{
+		fprintf(stderr, "mkxp-pack: %s\n", SDL_GetError());
+		return 1;
+	}
+
+	std::vector<TreeEntry> tree;
+	walkTree("", tree);
+
+	if (bundle)
+	{
+		/* Drop the previous bundle; it is regenerated below */
+		for (size_t i = tree.size(); i > 0; --i)
+		{
+			if (!inBundleDir(tree[i-1].path))
+				continue;
+
+			if (tree[i-1].isFile)
+				remove(tree[i-1].path.c_str());
+
+			tree.erase(tree.begin() + (i-1));
+		}
+	}
+
+	std::vector<Entry> entries(tree.begin(), tree.end());
+
+	/* Work stealing over the sorted list keeps the output order */
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> workers;
+	unsigned int threadCount = std::max(1u, std::thread::hardware_concurrency());
+
+	for (unsigned int i = 0; i < threadCount; ++i)
+		workers.push_back(std::thread([&]()
+		{
+			for (size_t j = next++; j < entries.size(); j = next++)
+				processEntry(entries[j]);
+		}));
+
+	for (size_t i = 0; i < workers.size(); ++i)
+		workers[i].join();
+
+	if (bundle)
+	{
+		std::vector<std::string> written;
+
+		if (!writeBundle(entries, written))
+		{
+			fprintf(stderr, "mkxp-pack: cannot write bundle\n");
+			return 1;
+		}
+
+		/* The bundle itself is served like any other file */
+		TreeEntry dir = { bundleDir, false };
+		entries.push_back(Entry(dir));
+
+		for (size_t i = 0; i < written.size(); ++i)
+		{
+			TreeEntry file = { written[i], true };
+			entries.push_back(Entry(file));
+			processEntry(entries.back());
+		}
+	}
+
+	FILE *mapping = fopen("mapping.js", "w");
+	FILE *bitmaps = fopen("bitmap-map.js", "w");
+
+	if (!mapping || !bitmaps)
+	{
+		fprintf(stderr, "mkxp-pack: cannot write output files\n");
+		return 1;
+	}
+
+	fprintf(mapping, "var mappingArray = [\n");
+	fprintf(bitmaps, "var bitmapSizeMapping = {\n");
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		const Entry &e = entries[i];
+		const std::string name = jsString(assetName(e.path));
+
+		if (e.isImage)
+			fprintf(bitmaps, "%s: [%d,%d,%s],\n", name.c_str(),
+			        e.width, e.height, jsString(e.thumbURI).c_str());
+
+		fprintf(mapping, "[%s, %s],\n", name.c_str(),
+		        jsString(e.path + "?h=" + e.hash).c_str());
+	}
+
+	fprintf(mapping, "];\n");
+	fprintf(bitmaps, "};\n");
+
+	fprintf(mapping,
+	        "\n"
+	        "var mapping = {};\n"
+	        "for (var i = 0; i < mappingArray.length; i++) {\n"
+	        "    mapping[mappingArray[i][0]] = mappingArray[i][1];\n"
+	        "}\n"
+	        "\n");
+
+	fclose(mapping);
+	fclose(bitmaps);
+
+	IMG_Quit();
+	SDL_Quit();
+
+	return 0;
+}
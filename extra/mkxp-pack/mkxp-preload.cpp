@@ -0,0 +1,472 @@
+/*
+** mkxp-preload.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/* Native replacement for dump.sh. Run inside the game directory
+ * with the data files to process (eg. everything in Data/);
+ * writes the assets each one references to preload/<file>.json.
+ *
+ * Every String in the Marshal stream (map/event names, event
+ * command parameters, animation names etc.) is looked up in an
+ * index of the game tree, the same way dump.sh matched YAML values
+ * with 'find -name "$value.*"', but without a Ruby VM and with a
+ * single pass over the tree.
+ *
+ * Maps reachable through "Transfer Player" commands are listed
+ * after the assets, so the engine can prefetch for them too */
+
+#include "gametree.h"
+
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/* Streaming Marshal (format 4.8) reader that collects all Strings
+ * in stream order, as well as the target map IDs of transfer
+ * commands. Since nothing is reconstructed, only the symbol
+ * table has to be kept */
+class MarshalScanner
+{
+public:
+	MarshalScanner(const std::vector<uint8_t> &data)
+	    : p(data.empty() ? 0 : &data[0]),
+	      end(p + data.size())
+	{}
+
+	void scan(std::vector<std::string> &strings, std::vector<int> &transfers)
+	{
+		out = &strings;
+		mapIDs = &transfers;
+
+		if (readByte() != 4 || readByte() != 8)
+			throw std::runtime_error("not a Marshal 4.8 stream");
+
+		value();
+	}
+
+private:
+	const uint8_t *p;
+	const uint8_t *end;
+	std::vector<std::string> *out;
+	std::vector<int> *mapIDs;
+	std::vector<std::string> symbols;
+
+	uint8_t readByte()
+	{
+		if (p >= end)
+			throw std::runtime_error("unexpected end of data");
+
+		return *p++;
+	}
+
+	int readInt()
+	{
+		const int8_t c = (int8_t) readByte();
+
+		if (c == 0)
+			return 0;
+
+		if (c > 4)
+			return c - 5;
+
+		if (c < -4)
+			return c + 5;
+
+		int x = c > 0 ? 0 : -1;
+
+		for (int i = 0; i < (c > 0 ? c : -c); ++i)
+		{
+			x &= ~(0xFF << (8*i));
+			x |= readByte() << (8*i);
+		}
+
+		return x;
+	}
+
+	void skip(int n)
+	{
+		if (n < 0 || end - p < n)
+			throw std::runtime_error("unexpected end of data");
+
+		p += n;
+	}
+
+	std::string readBytes()
+	{
+		const int n = readInt();
+		const uint8_t *start = p;
+
+		skip(n);
+
+		return std::string((const char*) start, n);
+	}
+
+	std::string symbol()
+	{
+		const uint8_t type = readByte();
+
+		if (type == ':')
+		{
+			symbols.push_back(readBytes());
+			return symbols.back();
+		}
+
+		if (type == ';')
+		{
+			const int idx = readInt();
+
+			if (idx < 0 || idx >= (int) symbols.size())
+				throw std::runtime_error("bad symbol link");
+
+			return symbols[idx];
+		}
+
+		if (type == 'I')
+		{
+			const std::string sym = symbol();
+			pairs();
+
+			return sym;
+		}
+
+		throw std::runtime_error("symbol expected");
+	}
+
+	/* -1 for anything but a Fixnum */
+	int intValue()
+	{
+		if (p < end && *p == 'i')
+		{
+			++p;
+			return readInt();
+		}
+
+		value();
+
+		return -1;
+	}
+
+	/* Only the first two parameters matter to us:
+	 * [0 (direct designation), map ID, x, y, direction] */
+	void eventCommand()
+	{
+		int code = -1;
+		int params[2] = { -1, -1 };
+
+		for (int n = readInt(); n > 0; --n)
+		{
+			const std::string ivar = symbol();
+
+			if (ivar == "@code")
+			{
+				code = intValue();
+			}
+			else if (ivar == "@parameters" && p < end && *p == '[')
+			{
+				++p;
+
+				for (int i = 0, m = readInt(); i < m; ++i)
+					if (i < 2)
+						params[i] = intValue();
+					else
+						value();
+			}
+			else
+			{
+				value();
+			}
+		}
+
+		/* Transfer Player */
+		if (code == 201 && params[0] == 0 && params[1] > 0)
+			mapIDs->push_back(params[1]);
+	}
+
+	void pairs()
+	{
+		for (int n = readInt(); n > 0; --n)
+		{
+			value();
+			value();
+		}
+	}
+
+	void value()
+	{
+		const uint8_t type = readByte();
+
+		switch (type)
+		{
+		case '0' :
+		case 'T' :
+		case 'F' :
+			break;
+
+		case 'i' :
+		case '@' :
+			readInt();
+			break;
+
+		case ':' :
+		case ';' :
+			--p;
+			symbol();
+			break;
+
+		case '"' :
+			out->push_back(readBytes());
+			break;
+
+		case 'f' :
+		case 'c' :
+		case 'm' :
+		case 'M' :
+			readBytes();
+			break;
+
+		case '/' :
+			readBytes();
+			readByte();
+			break;
+
+		case 'l' :
+			readByte();
+			skip(readInt() * 2);
+			break;
+
+		case 'I' :
+			value();
+			pairs();
+			break;
+
+		case '[' :
+			for (int n = readInt(); n > 0; --n)
+				value();
+			break;
+
+		case '{' :
+			pairs();
+			break;
+
+		case '}' :
+			pairs();
+			value();
+			break;
+
+		case 'o' :
+			if (symbol() == "RPG::EventCommand")
+				eventCommand();
+			else
+				pairs();
+			break;
+
+		case 'S' :
+			value();
+			pairs();
+			break;
+
+		case 'u' :
+			/* _dump data (Table, Color, Tone) */
+			value();
+			readBytes();
+			break;
+
+		case 'U' :
+		case 'e' :
+		case 'C' :
+		case 'd' :
+			value();
+			value();
+			break;
+
+		default :
+			throw std::runtime_error(std::string("unknown type byte '") +
+			                         (char) type + "'");
+		}
+	}
+};
+
+/* dump.sh stripped blanks, '*' and quotes from the YAML values */
+static std::string cleanValue(const std::string &value)
+{
+	std::string str;
+	str.reserve(value.size());
+
+	for (size_t i = 0; i < value.size(); ++i)
+		if (!strchr(" \t*'", value[i]))
+			str += value[i];
+
+	return str;
+}
+
+/* The strings dump.sh never considered asset names */
+static bool ignoredValue(const std::string &str)
+{
+	if (str.empty() || str == "A")
+		return true;
+
+	if (str.find_first_not_of("0123456789.-") == std::string::npos)
+		return true;
+
+	if (str.size() > 2 && str.compare(0, 2, "EV") == 0 &&
+	    str.find_first_not_of("0123456789", 2) == std::string::npos)
+		return true;
+
+	return false;
+}
+
+static void makeParentDirs(const std::string &path)
+{
+	for (size_t i = path.find('/'); i != std::string::npos; i = path.find('/', i+1))
+		mkdir(path.substr(0, i).c_str(), 0755);
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: mkxp-preload DATAFILE...\n");
+		return 1;
+	}
+
+	/* Index the tree: a file named "a.b.png" is found
+	 * by both "a" and "a.b" (like 'find -name "$value.*"') */
+	std::vector<TreeEntry> tree;
+	walkTree("", tree);
+
+	std::unordered_map<std::string, std::vector<const std::string*> > index;
+	std::unordered_map<std::string, const std::string*> byPath;
+
+	for (size_t i = 0; i < tree.size(); ++i)
+	{
+		const std::string &path = tree[i].path;
+
+		/* Don't index our own output */
+		if (path.compare(0, 8, "preload/") == 0 || path == "preload")
+			continue;
+
+		byPath[path] = &path;
+
+		const size_t nameStart = path.rfind('/') + 1;
+
+		for (size_t dot = path.find('.', nameStart + 1); dot != std::string::npos;
+		     dot = path.find('.', dot + 1))
+			index[path.substr(nameStart, dot - nameStart)].push_back(&path);
+	}
+
+	int failures = 0;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string file = argv[i];
+		std::vector<uint8_t> data;
+		std::vector<std::string> strings;
+		std::vector<int> transfers;
+
+		if (!readFile(file, data))
+		{
+			fprintf(stderr, "mkxp-preload: cannot read %s\n", file.c_str());
+			++failures;
+			continue;
+		}
+
+		try
+		{
+			MarshalScanner(data).scan(strings, transfers);
+		}
+		catch (const std::runtime_error &e)
+		{
+			/* Data/ also holds things like Thumbs.db; like the
+			 * old dump.sh loop, skip them and carry on */
+			fprintf(stderr, "mkxp-preload: skipping %s: %s\n", file.c_str(), e.what());
+			continue;
+		}
+
+		std::set<std::string> seenValues;
+		std::set<const std::string*> seenFiles;
+		std::vector<const std::string*> files;
+
+		for (size_t j = 0; j < strings.size(); ++j)
+		{
+			const std::string value = cleanValue(strings[j]);
+
+			if (ignoredValue(value) || !seenValues.insert(value).second)
+				continue;
+
+			auto match = index.find(value);
+
+			if (match == index.end())
+				continue;
+
+			for (size_t k = 0; k < match->second.size(); ++k)
+				if (seenFiles.insert(match->second[k]).second)
+					files.push_back(match->second[k]);
+		}
+
+		/* Map files live next to the one scanned, with the same extension */
+		const size_t nameStart = file.rfind('/') + 1;
+		const size_t extStart = file.rfind('.');
+		const std::string mapExt =
+			(extStart != std::string::npos && extStart > nameStart) ? file.substr(extStart) : "";
+		const size_t assetCount = files.size();
+
+		for (size_t j = 0; j < transfers.size(); ++j)
+		{
+			char mapName[32];
+			snprintf(mapName, sizeof(mapName), "Map%03d", transfers[j]);
+
+			auto match = byPath.find(file.substr(0, nameStart) + mapName + mapExt);
+
+			if (match != byPath.end() && seenFiles.insert(match->second).second)
+				files.push_back(match->second);
+		}
+
+		const std::string outPath = "preload/" + file + ".json";
+		makeParentDirs(outPath);
+
+		FILE *f = fopen(outPath.c_str(), "w");
+
+		if (!f)
+		{
+			fprintf(stderr, "mkxp-preload: cannot write %s\n", outPath.c_str());
+			++failures;
+			continue;
+		}
+
+		fprintf(f, "[\n");
+
+		for (size_t j = 0; j < files.size(); ++j)
+			fprintf(f, "\"%s\"%s\n", files[j]->c_str(), j+1 < files.size() ? "," : "");
+
+		fprintf(f, "]\n");
+		fclose(f);
+
+		printf("Processed file: %s (%u assets, %u maps)\n", file.c_str(),
+		       (unsigned) assetCount, (unsigned) (files.size() - assetCount));
+	}
+
+	return failures ? 1 : 0;
+}
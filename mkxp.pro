@@ -99,6 +99,9 @@ HEADERS += \
 	src/sprite.h \
 	src/table.h \
 	src/texpool.h \
+	src/prefetcher.h \
+	src/savewriter.h \
+	src/programcache.h \
 	src/tilequad.h \
 	src/transform.h \
 	src/viewport.h \
@@ -122,6 +125,7 @@ HEADERS += \
 	src/config.h \
 	src/settingsmenu.h \
 	src/keybindings.h \
+	src/scriptcache.h \
 	src/tileatlas.h \
 	src/sharedstate.h \
 	src/al-util.h \
@@ -135,9 +139,11 @@ HEADERS += \
 	src/alstream.h \
 	src/audiostream.h \
 	src/rgssad.h \
+	src/bundle.h \
 	src/windowvx.h \
 	src/tilemapvx.h \
 	src/tileatlasvx.h \
+	src/autotilesvx.h \
 	src/sharedmidistate.h \
 	src/fluid-fun.h \
 	src/sdl-util.h
@@ -159,6 +165,9 @@ SOURCES += \
 	src/viewport.cpp \
 	src/window.cpp \
 	src/texpool.cpp \
+	src/prefetcher.cpp \
+	src/savewriter.cpp \
+	src/programcache.cpp \
 	src/shader.cpp \
 	src/glstate.cpp \
 	src/tilemap.cpp \
@@ -169,6 +178,7 @@ SOURCES += \
 	src/config.cpp \
 	src/settingsmenu.cpp \
 	src/keybindings.cpp \
+	src/scriptcache.cpp \
 	src/tileatlas.cpp \
 	src/sharedstate.cpp \
 	src/gl-fun.cpp \
@@ -179,6 +189,7 @@ SOURCES += \
 	src/alstream.cpp \
 	src/audiostream.cpp \
 	src/rgssad.cpp \
+	src/bundle.cpp \
 	src/bundledfont.cpp \
 	src/vorbissource.cpp \
 	src/windowvx.cpp \
@@ -195,7 +206,7 @@ EMBED = \
 	shader/hue.frag \
 	shader/sprite.frag \
 	shader/plane.frag \
-	shader/gray.frag \
+	shader/viewport.frag \
 	shader/bitmapBlit.frag \
 	shader/flatColor.frag \
 	shader/simple.frag \
@@ -258,7 +269,8 @@ BINDING_MRUBY {
 	binding-mruby/serializable-binding.h \
 	binding-mruby/mrb-ext/file.h \
 	binding-mruby/mrb-ext/rwmem.h \
-	binding-mruby/mrb-ext/marshal.h
+	binding-mruby/mrb-ext/marshal.h \
+	binding-mruby/mrb-ext/marshal-load.h
 
 	SOURCES += \
 	binding-mruby/binding-mruby.cpp \
@@ -278,6 +290,7 @@ BINDING_MRUBY {
 	binding-mruby/module_rpg.c \
 	binding-mruby/mrb-ext/file.cpp \
 	binding-mruby/mrb-ext/marshal.cpp \
+	binding-mruby/mrb-ext/marshal-load.cpp \
 	binding-mruby/mrb-ext/rwmem.cpp \
 	binding-mruby/mrb-ext/kernel.cpp \
 	binding-mruby/mrb-ext/time.cpp
@@ -325,6 +338,7 @@ BINDING_MRI {
 	binding-mri/audio-binding.cpp \
 	binding-mri/module_rpg.cpp \
 	binding-mri/filesystem-binding.cpp \
+	binding-mri/marshal-load.cpp \
 	binding-mri/windowvx-binding.cpp \
 	binding-mri/tilemapvx-binding.cpp
 }
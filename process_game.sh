@@ -51,7 +51,12 @@ fi
 
 # Make mappings
 echo "Generating file mappings..."
-bash ../make_mapping.sh
+if [ -x ../mkxp-pack ]; then
+    # MKXP_BUNDLE=1 additionally packs the assets into Bundle/
+    ../mkxp-pack ${MKXP_BUNDLE:+--bundle}
+else
+    bash ../make_mapping.sh
+fi
 
 # Preload data
 echo "Generating preload data..."
@@ -66,12 +71,16 @@ mkdir -p preload
 
 # Only process if Data folder exists
 if [ -d "Data" ]; then
-    for f in Data/*; do
-        if [ -f "$f" ]; then
-            bash ./dump.sh "$f" > /dev/null
-            echo "Processed file: $f"
-        fi
-    done
+    if [ -x ../mkxp-preload ]; then
+        find Data -maxdepth 1 -type f -print0 | xargs -0 -r ../mkxp-preload
+    else
+        for f in Data/*; do
+            if [ -f "$f" ]; then
+                bash ./dump.sh "$f" > /dev/null
+                echo "Processed file: $f"
+            fi
+        done
+    fi
 fi
 
 # Move preload out
@@ -25,6 +25,7 @@
 #include "sharedmidistate.h"
 #include "eventthread.h"
 #include "filesystem.h"
+#include "prefetcher.h"
 #include "exception.h"
 #include "aldatasource.h"
 #include "fluid-fun.h"
@@ -262,6 +263,8 @@ struct ALStreamOpenHandler : FileSystem::OpenHandler
 
 void ALStream::openSource(const std::string &filename)
 {
+	shState->prefetcher().demand(filename.c_str());
+
 #ifdef __EMSCRIPTEN__
 	load_file_async_js(filename.c_str());
 #endif
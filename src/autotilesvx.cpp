@@ -1,615 +1,771 @@
-struct StaticRect { float x, y, w, h; };
+#include "autotilesvx.h"
 
-extern const StaticRect autotileVXRectsA[] =
+/* Regular (A) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsA[] =
 {
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 0.5, 0.5, 15, 15 },
-	{ 16.5, 0.5, 15, 15 },
-	{ 0.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 15, 15 }
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} }
 };
 
-extern const int autotileVXRectsAN = sizeof(autotileVXRectsA) / sizeof(autotileVXRectsA[0]);
+extern const int autotileVXPatternsAN = sizeof(autotileVXPatternsA) / sizeof(autotileVXPatternsA[0]);
 
-extern const StaticRect autotileVXRectsA2[] =
+/* Table (A2) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsA2[] =
 {
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 32.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 16.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 0, 0 },
-	{ 16.5, 16.5, 0, 0 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 16.5, 80.5, 15, 15 },
-	{ 0.5, 64.5, 15, 15 },
-	{ 48.5, 64.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 80.5, 15, 15 },
-	{ 48.5, 80.5, 15, 15 },
-	{ 0.5, 0.5, 15, 15 },
-	{ 16.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 15, 15 }
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 5, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 5, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 5, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 6, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {   1, 129,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97, 129,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {  65, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {   1, 161,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  97, 161,  30,  30 }, { 32, 48, 32, 32 } }
+	} },
+	{ 6, {
+		{ {   1,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } },
+		{ {   1,  33,  30,  30 }, {  0, 48, 32, 32 } },
+		{ {  33,  33,  30,  30 }, { 32, 48, 32, 32 } }
+	} }
 };
 
-extern const int autotileVXRectsA2N = sizeof(autotileVXRectsA2) / sizeof(autotileVXRectsA2[0]);
+extern const int autotileVXPatternsA2N = sizeof(autotileVXPatternsA2) / sizeof(autotileVXPatternsA2[0]);
 
-extern const float autotileVXRectsA2Sizes[] =
+/* Wall (B) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsB[] =
 {
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 0.0, 0.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0,
-	16.0, 16.0, 16.0, 16.0, 16.0, 16.0
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  33,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  33,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  33,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  33,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,  65,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,  65,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {  65,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {  65,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} },
+	{ 4, {
+		{ {   1,   1,  30,  30 }, {  0,  0, 32, 32 } },
+		{ {  97,   1,  30,  30 }, { 32,  0, 32, 32 } },
+		{ {   1,  97,  30,  30 }, {  0, 32, 32, 32 } },
+		{ {  97,  97,  30,  30 }, { 32, 32, 32, 32 } }
+	} }
 };
 
-extern const StaticRect autotileVXRectsB[] =
+extern const int autotileVXPatternsBN = sizeof(autotileVXPatternsB) / sizeof(autotileVXPatternsB[0]);
+
+/* Waterfall (C) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsC[] =
 {
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 0.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 15, 15 },
-	{ 0.5, 0.5, 15, 15 },
-	{ 16.5, 0.5, 15, 15 },
-	{ 0.5, 16.5, 15, 15 },
-	{ 16.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 0.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 0.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 16.5, 15, 15 },
-	{ 48.5, 16.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 16.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 16.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 0.5, 0.5, 15, 15 },
-	{ 16.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 16.5, 48.5, 15, 15 },
-	{ 32.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 32.5, 15, 15 },
-	{ 48.5, 32.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 32.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 32.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 },
-	{ 0.5, 0.5, 15, 15 },
-	{ 48.5, 0.5, 15, 15 },
-	{ 0.5, 48.5, 15, 15 },
-	{ 48.5, 48.5, 15, 15 }
+	{ 2, {
+		{ {  65,   1,  30,  62 }, {  0,  0, 32, 64 } },
+		{ {  33,   1,  30,  62 }, { 32,  0, 32, 64 } }
+	} },
+	{ 2, {
+		{ {   0,   1,  30,  62 }, {  0,  0, 32, 64 } },
+		{ {  33,   1,  30,  62 }, { 32,  0, 32, 64 } }
+	} },
+	{ 2, {
+		{ {  65,   1,  30,  62 }, {  0,  0, 32, 64 } },
+		{ {  97,   1,  30,  62 }, { 32,  0, 32, 64 } }
+	} },
+	{ 2, {
+		{ {   0,   1,  30,  62 }, {  0,  0, 32, 64 } },
+		{ {  97,   1,  30,  62 }, { 32,  0, 32, 64 } }
+	} }
 };
 
-extern const int autotileVXRectsBN = sizeof(autotileVXRectsB) / sizeof(autotileVXRectsB[0]);
+extern const int autotileVXPatternsCN = sizeof(autotileVXPatternsC) / sizeof(autotileVXPatternsC[0]);
@@ -0,0 +1,46 @@
+/*
+** autotilesvx.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef AUTOTILESVX_H
+#define AUTOTILESVX_H
+
+/* Sub quads of every VX autotile pattern, in half pixel units:
+ * texture rects relative to the autotile's atlas origin, position
+ * rects relative to the tile's top left corner. Empty quads are
+ * left out, so a tile only needs its pattern translated */
+struct AutotileQuadVX { unsigned char tex[4], pos[4]; };
+struct AutotilePatternVX { unsigned char n; AutotileQuadVX quads[6]; };
+
+/* Regular (A) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsA[];
+extern const int autotileVXPatternsAN;
+
+/* Table (A2) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsA2[];
+extern const int autotileVXPatternsA2N;
+
+/* Wall (B) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsB[];
+extern const int autotileVXPatternsBN;
+
+/* Waterfall (C) autotile patterns */
+extern const AutotilePatternVX autotileVXPatternsC[];
+extern const int autotileVXPatternsCN;
+
+#endif // AUTOTILESVX_H
@@ -28,6 +28,11 @@
 #include <SDL_surface.h>
 
 #include <pixman.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include "gl-util.h"
 #include "gl-meta.h"
@@ -39,6 +44,7 @@
 #include "sharedstate.h"
 #include "glstate.h"
 #include "texpool.h"
+#include "prefetcher.h"
 #include "shader.h"
 #include "filesystem.h"
 #include "font.h"
@@ -78,19 +84,183 @@ static IntRect normalizedRect(const IntRect &rect)
 	return norm;
 }
 
+/* Rows per compressed band of a mega surface; one tileset row */
+#define MEGA_BAND_ROWS 32
+
+/* An image too big for a texture. Only tilemaps (and blt) read it,
+ * and a map references few of a giant tileset's rows, so it is
+ * kept as zlib compressed bands of rows. Reads inflate the bands
+ * they cover into a scratch surface */
+struct MegaSurface
+{
+	int w, h;
+
+	std::vector<std::string> bands;
+
+	/* Holds rows [scratchY, scratchY + scratch->h) */
+	SDL_Surface *scratch;
+	int scratchY;
+
+	/* Takes ownership of 'surf' (in ABGR8888) */
+	MegaSurface(SDL_Surface *surf)
+	    : w(surf->w),
+	      h(surf->h),
+	      scratch(0),
+	      scratchY(0)
+	{
+		const size_t rowSize = w * 4;
+		std::vector<Bytef> raw(rowSize * MEGA_BAND_ROWS);
+		std::vector<Bytef> packed(compressBound(raw.size()));
+
+		bands.resize((h + MEGA_BAND_ROWS - 1) / MEGA_BAND_ROWS);
+
+		for (size_t b = 0; b < bands.size(); ++b)
+		{
+			const int y0 = b * MEGA_BAND_ROWS;
+			const int rows = std::min(MEGA_BAND_ROWS, h - y0);
+
+			for (int y = 0; y < rows; ++y)
+				memcpy(&raw[y * rowSize],
+				       (const uint8_t*) surf->pixels + (y0 + y) * surf->pitch, rowSize);
+
+			uLongf packedSize = packed.size();
+
+			if (compress2(&packed[0], &packedSize, &raw[0],
+			              rows * rowSize, Z_BEST_SPEED) != Z_OK)
+			{
+				SDL_FreeSurface(surf);
+				throw Exception(Exception::MKXPError,
+				                "Error compressing mega surface band %d", (int) b);
+			}
+
+			bands[b].assign((const char*) &packed[0], packedSize);
+		}
+
+		SDL_FreeSurface(surf);
+	}
+
+	~MegaSurface()
+	{
+		if (scratch)
+			SDL_FreeSurface(scratch);
+	}
+
+	/* Rows [y, y+rowCount) clipped to the image; 'top' receives
+	 * the first row held. Null if nothing is left after clipping */
+	SDL_Surface *rows(int y, int rowCount, int &top)
+	{
+		const int y0 = std::max(y, 0);
+		const int y1 = std::min(y + rowCount, h);
+
+		top = y0;
+
+		if (y1 <= y0)
+			return 0;
+
+		if (scratch && scratchY == y0 && scratch->h == y1 - y0)
+			return scratch;
+
+		if (scratch)
+			SDL_FreeSurface(scratch);
+
+		int bpp;
+		Uint32 rMask, gMask, bMask, aMask;
+		SDL_PixelFormatEnumToMasks(SDL_PIXELFORMAT_ABGR8888,
+		                           &bpp, &rMask, &gMask, &bMask, &aMask);
+
+		scratch = SDL_CreateRGBSurface(0, w, y1 - y0, bpp, rMask, gMask, bMask, aMask);
+		scratchY = y0;
+
+		if (!scratch)
+			throw Exception(Exception::SDLError, "Error creating surface: %s",
+			                SDL_GetError());
+
+		SDL_SetSurfaceBlendMode(scratch, SDL_BLENDMODE_NONE);
+
+		const size_t rowSize = w * 4;
+		std::vector<Bytef> raw(rowSize * MEGA_BAND_ROWS);
+
+		for (int b = y0 / MEGA_BAND_ROWS; b * MEGA_BAND_ROWS < y1; ++b)
+		{
+			const int bandY = b * MEGA_BAND_ROWS;
+			const size_t bandSize = std::min(MEGA_BAND_ROWS, h - bandY) * rowSize;
+
+			uLongf rawSize = raw.size();
+
+			if (uncompress(&raw[0], &rawSize, (const Bytef*) bands[b].data(),
+			               bands[b].size()) != Z_OK || rawSize != bandSize)
+			{
+				/* Don't hand out the half filled scratch later */
+				SDL_FreeSurface(scratch);
+				scratch = 0;
+
+				throw Exception(Exception::MKXPError,
+				                "Corrupt mega surface band %d", b);
+			}
+
+			const int from = std::max(y0, bandY);
+			const int to = std::min(y1, bandY + MEGA_BAND_ROWS);
+
+			for (int row = from; row < to; ++row)
+				memcpy((uint8_t*) scratch->pixels + (row - y0) * scratch->pitch,
+				       &raw[(row - bandY) * rowSize], rowSize);
+		}
+
+		return scratch;
+	}
+};
+
+/* Content stamps are kept apart from SharedState::genTimeStamp(),
+ * which orders scene elements; bitmaps are modified far more often
+ * than elements are created, and 64 bits never wrap */
+static uint64_t contentStampCounter = 1;
+
+static uint64_t genContentStamp()
+{
+	return contentStampCounter++;
+}
+
+/* Pool textures are rounded up to a size class, and the margin
+ * past the requested size holds whatever its previous user left
+ * there. Filtered or offset sampling along the right and bottom
+ * edges (blur, radial blur, smoothing) would pick that up, so it
+ * is cleared whenever there is a margin at all */
+static TEXFBO requestCleared(int width, int height)
+{
+	TEXFBO tex = shState->texPool().request(width, height);
+
+	if (tex.width == width && tex.height == height)
+		return tex;
+
+	FBO::bind(tex.fbo);
+
+	glState.scissorTest.pushSet(false);
+	glState.clearColor.pushSet(Vec4());
+	FBO::clear();
+	glState.clearColor.pop();
+	glState.scissorTest.pop();
+
+	return tex;
+}
+
 struct BitmapPrivate
 {
 	Bitmap *self;
 
 	TEXFBO gl;
 
+	/* The pooled texture backing a bitmap may be bigger than
+	 * the bitmap itself (see TexPool::request), so we keep
+	 * track of the actual (logical) bitmap size here */
+	Vec2i size;
+
 	Font *font;
 
 	/* "Mega surfaces" are a hack to allow Tilesets to be used
 	 * whose Bitmaps don't fit into a regular texture. They're
 	 * kept in RAM and will throw an error if they're used in
 	 * any context other than as Tilesets */
-	SDL_Surface *megaSurface;
+	MegaSurface *megaSurface;
 
 	/* A cached version of the bitmap in client memory, for
 	 * getPixel calls. Is invalidated any time the bitmap
@@ -106,10 +276,20 @@ struct BitmapPrivate
 	 * ourselves the expensive blending calculation */
 	pixman_region16_t tainted;
 
+	/* Identifies the current contents; renewed on every
+	 * modification, and unique across all bitmaps */
+	uint64_t stamp;
+
+	/* Every pixel is known to have full opacity. Only
+	 * established at load time; any modification clears it */
+	bool opaque;
+
 	BitmapPrivate(Bitmap *self)
 	    : self(self),
 	      megaSurface(0),
-	      surface(0)
+	      surface(0),
+	      stamp(genContentStamp()),
+	      opaque(false)
 	{
 		format = SDL_AllocFormat(SDL_PIXELFORMAT_ABGR8888);
 
@@ -125,7 +305,7 @@ struct BitmapPrivate
 
 	void allocSurface()
 	{
-		surface = SDL_CreateRGBSurface(0, gl.width, gl.height, format->BitsPerPixel,
+		surface = SDL_CreateRGBSurface(0, size.x, size.y, format->BitsPerPixel,
 		                               format->Rmask, format->Gmask,
 		                               format->Bmask, format->Amask);
 	}
@@ -233,10 +413,30 @@ struct BitmapPrivate
 			surface = 0;
 		}
 
+		stamp = genContentStamp();
+		opaque = false;
+
 		self->modified();
 	}
 };
 
+static bool surfaceOpaque(SDL_Surface *surf)
+{
+	const uint32_t amask = surf->format->Amask;
+
+	for (int y = 0; y < surf->h; ++y)
+	{
+		const uint32_t *row = (const uint32_t*)
+			((const uint8_t*) surf->pixels + y*surf->pitch);
+
+		for (int x = 0; x < surf->w; ++x)
+			if ((row[x] & amask) != amask)
+				return false;
+	}
+
+	return true;
+}
+
 struct BitmapOpenHandler : FileSystem::OpenHandler
 {
 	SDL_Surface *surf;
@@ -272,8 +472,11 @@ void Bitmap::loadFromFilename()
 		this->releaseResources();
 		reloading = true;
 	} else {
+		shState->prefetcher().demand(filename);
 		load_file_async_js(filename, (int)this);
 	}
+#else
+	shState->prefetcher().demand(filename);
 #endif
 
 	BitmapOpenHandler handler;
@@ -292,8 +495,7 @@ void Bitmap::loadFromFilename()
 	{
 		/* Mega surface */
 		p = new BitmapPrivate(this);
-		p->megaSurface = imgSurf;
-		SDL_SetSurfaceBlendMode(p->megaSurface, SDL_BLENDMODE_NONE);
+		p->megaSurface = new MegaSurface(imgSurf);
 	}
 	else
 	{
@@ -302,7 +504,7 @@ void Bitmap::loadFromFilename()
 
 		try
 		{
-			tex = shState->texPool().request(imgSurf->w, imgSurf->h);
+			tex = requestCleared(imgSurf->w, imgSurf->h);
 		}
 		catch (const Exception &e)
 		{
@@ -312,9 +514,11 @@ void Bitmap::loadFromFilename()
 
 		p = new BitmapPrivate(this);
 		p->gl = tex;
+		p->size = Vec2i(imgSurf->w, imgSurf->h);
+		p->opaque = surfaceOpaque(imgSurf);
 
 		TEX::bind(p->gl.tex);
-		TEX::uploadImage(p->gl.width, p->gl.height, imgSurf->pixels, GL_RGBA);
+		TEX::uploadSubImage(0, 0, imgSurf->w, imgSurf->h, imgSurf->pixels, GL_RGBA);
 
 		SDL_FreeSurface(imgSurf);
 	}
@@ -336,6 +540,7 @@ Bitmap::Bitmap(int width, int height)
 
 	p = new BitmapPrivate(this);
 	p->gl = tex;
+	p->size = Vec2i(width, height);
 
 	clear();
 }
@@ -346,7 +551,8 @@ Bitmap::Bitmap(const Bitmap &other)
 
 	p = new BitmapPrivate(this);
 
-	p->gl = shState->texPool().request(other.width(), other.height());
+	p->gl = requestCleared(other.width(), other.height());
+	p->size = other.p->size;
 
 	blt(0, 0, other, rect());
 }
@@ -363,7 +569,7 @@ int Bitmap::width() const
 	if (p->megaSurface)
 		return p->megaSurface->w;
 
-	return p->gl.width;
+	return p->size.x;
 }
 
 int Bitmap::height() const
@@ -373,7 +579,7 @@ int Bitmap::height() const
 	if (p->megaSurface)
 		return p->megaSurface->h;
 
-	return p->gl.height;
+	return p->size.y;
 }
 
 IntRect Bitmap::rect() const
@@ -429,20 +635,30 @@ void Bitmap::stretchBlt(const IntRect &destRect,
 	}
 #endif
 
-	SDL_Surface *srcSurf = source.megaSurface();
+	const bool srcMega = source.isMega();
+	int srcTop = 0;
+	SDL_Surface *srcSurf = 0;
+
+	if (srcMega)
+	{
+		srcSurf = source.megaRows(sourceRect.y, sourceRect.h, srcTop);
+
+		if (!srcSurf)
+			return;
+	}
 
-	if (srcSurf && shState->config().subImageFix)
+	if (srcMega && shState->config().subImageFix)
 	{
 		/* Blit from software surface, for broken GL drivers */
 		Vec2i gpTexSize;
 		shState->ensureTexSize(sourceRect.w, sourceRect.h, gpTexSize);
 		shState->bindTex();
 
-		GLMeta::subRectImageUpload(srcSurf->w, sourceRect.x, sourceRect.y, 0, 0,
+		GLMeta::subRectImageUpload(srcSurf->w, sourceRect.x, sourceRect.y - srcTop, 0, 0,
 		                           sourceRect.w, sourceRect.h, srcSurf, GL_RGBA);
 		GLMeta::subRectImageEnd();
 
-		SimpleShader &shader = shState->shaders().simple;
+		SimpleShader &shader = shState->shaders().simple();
 		shader.bind();
 		shader.setTranslation(Vec2i());
 		shader.setTexSize(gpTexSize);
@@ -462,7 +678,7 @@ void Bitmap::stretchBlt(const IntRect &destRect,
 
 		return;
 	}
-	else if (srcSurf)
+	else if (srcMega)
 	{
 		/* Blit from software surface */
 		/* Don't do transparent blits for now */
@@ -470,6 +686,7 @@ void Bitmap::stretchBlt(const IntRect &destRect,
 			source.ensureNonMega();
 
 		SDL_Rect srcRect = sourceRect;
+		srcRect.y -= srcTop;
 		SDL_Rect dstRect = destRect;
 		SDL_Rect btmRect = { 0, 0, width(), height() };
 		SDL_Rect bltRect;
@@ -529,12 +746,16 @@ void Bitmap::stretchBlt(const IntRect &destRect,
 		GLMeta::blitRectangle(destRect, Vec2i());
 		GLMeta::blitEnd();
 
-		FloatRect bltSubRect((float) sourceRect.x / source.width(),
-		                     (float) sourceRect.y / source.height(),
-		                     ((float) source.width() / sourceRect.w) * ((float) destRect.w / gpTex.width),
-		                     ((float) source.height() / sourceRect.h) * ((float) destRect.h / gpTex.height));
+		/* Texture coordinates are normalized against the
+		 * (possibly bigger) source texture, not the bitmap */
+		const TEXFBO &srcTex = source.p->gl;
+
+		FloatRect bltSubRect((float) sourceRect.x / srcTex.width,
+		                     (float) sourceRect.y / srcTex.height,
+		                     ((float) srcTex.width / sourceRect.w) * ((float) destRect.w / gpTex.width),
+		                     ((float) srcTex.height / sourceRect.h) * ((float) destRect.h / gpTex.height));
 
-		BltShader &shader = shState->shaders().blt;
+		BltShader &shader = shState->shaders().blt();
 		shader.bind();
 		shader.setDestination(gpTex.tex);
 		shader.setSubRect(bltSubRect);
@@ -598,7 +819,7 @@ void Bitmap::gradientFillRect(const IntRect &rect,
 
 	GUARD_MEGA;
 
-	SimpleColorShader &shader = shState->shaders().simpleColor;
+	SimpleColorShader &shader = shState->shaders().simpleColor();
 	shader.bind();
 	shader.setTranslation(Vec2i());
 
@@ -659,9 +880,9 @@ void Bitmap::blur()
 	FloatRect rect(0, 0, width(), height());
 	quad.setTexPosRect(rect, rect);
 
-	TEXFBO auxTex = shState->texPool().request(width(), height());
+	TEXFBO auxTex = requestCleared(width(), height());
 
-	BlurShader &shader = shState->shaders().blur;
+	BlurShader &shader = shState->shaders().blur();
 	BlurShader::HPass &pass1 = shader.pass1;
 	BlurShader::VPass &pass2 = shader.pass2;
 
@@ -672,7 +893,7 @@ void Bitmap::blur()
 	FBO::bind(auxTex.fbo);
 
 	pass1.bind();
-	pass1.setTexSize(Vec2i(width(), height()));
+	pass1.setTexSize(Vec2i(p->gl.width, p->gl.height));
 	pass1.applyViewportProj();
 
 	quad.draw();
@@ -681,7 +902,7 @@ void Bitmap::blur()
 	p->bindFBO();
 
 	pass2.bind();
-	pass2.setTexSize(Vec2i(width(), height()));
+	pass2.setTexSize(Vec2i(auxTex.width, auxTex.height));
 	pass2.applyViewportProj();
 
 	quad.draw();
@@ -761,7 +982,7 @@ void Bitmap::radialBlur(int angle, int divisions)
 
 	glState.blendMode.pushSet(BlendAddition);
 
-	SimpleMatrixShader &shader = shState->shaders().simpleMatrix;
+	SimpleMatrixShader &shader = shState->shaders().simpleMatrix();
 	shader.bind();
 
 	p->bindTexture(shader);
@@ -886,7 +1107,7 @@ void Bitmap::hueChange(int hue)
 	if ((hue % 360) == 0)
 		return;
 
-	TEXFBO newTex = shState->texPool().request(width(), height());
+	TEXFBO newTex = requestCleared(width(), height());
 
 	FloatRect texRect(rect());
 
@@ -894,7 +1115,7 @@ void Bitmap::hueChange(int hue)
 	quad.setTexPosRect(texRect, texRect);
 	quad.setColor(Vec4(1, 1, 1, 1));
 
-	HueShader &shader = shState->shaders().hue;
+	HueShader &shader = shState->shaders().hue();
 	shader.bind();
 	/* Shader expects normalized value */
 	shader.setHueAdjust(wrapRange(hue, 0, 359) / 360.0f);
@@ -1211,7 +1432,7 @@ void Bitmap::drawText(const IntRect &rect, const char *str, int align)
 		                  (float) (gpTexSize.x * squeeze) / gpTex2.width,
 		                  (float) gpTexSize.y / gpTex2.height);
 
-		BltShader &shader = shState->shaders().blt;
+		BltShader &shader = shState->shaders().blt();
 		shader.bind();
 		shader.setTexSize(gpTexSize);
 		shader.setSource();
@@ -1328,9 +1549,14 @@ TEXFBO &Bitmap::getGLTypes()
 	return p->gl;
 }
 
-SDL_Surface *Bitmap::megaSurface() const
+bool Bitmap::isMega() const
+{
+	return p->megaSurface != 0;
+}
+
+SDL_Surface *Bitmap::megaRows(int y, int rowCount, int &top) const
 {
-	return p->megaSurface;
+	return p->megaSurface->rows(y, rowCount, top);
 }
 
 void Bitmap::ensureNonMega() const
@@ -1351,10 +1577,20 @@ void Bitmap::taintArea(const IntRect &rect)
 	p->addTaintedArea(rect);
 }
 
+uint64_t Bitmap::contentStamp() const
+{
+	return p->stamp;
+}
+
+bool Bitmap::isOpaque() const
+{
+	return p->opaque;
+}
+
 void Bitmap::releaseResources()
 {
 	if (p->megaSurface)
-		SDL_FreeSurface(p->megaSurface);
+		delete p->megaSurface;
 	else
 		shState->texPool().release(p->gl);
 
@@ -28,6 +28,8 @@
 
 #include <sigc++/signal.h>
 
+#include <stdint.h>
+
 class Font;
 class ShaderBase;
 struct TEXFBO;
@@ -107,7 +109,13 @@ public:
 
 	/* <internal> */
 	TEXFBO &getGLTypes();
-	SDL_Surface *megaSurface() const;
+	bool isMega() const;
+
+	/* Mega surfaces only: rows [y, y+rowCount) of the image,
+	 * clipped to it, with 'top' set to the first one held. The
+	 * surface belongs to the bitmap and is valid until the next
+	 * call; null if the rows lie outside the image */
+	SDL_Surface *megaRows(int y, int rowCount, int &top) const;
 	void ensureNonMega() const;
 
 	/* Binds the backing texture and sets the correct
@@ -117,6 +125,13 @@ public:
 	/* Adds 'rect' to tainted area */
 	void taintArea(const IntRect &rect);
 
+	/* Changes whenever the contents do; never reused,
+	 * so it also tells apart different bitmaps */
+	uint64_t contentStamp() const;
+
+	/* True if every pixel is known to be fully opaque */
+	bool isOpaque() const;
+
 	sigc::signal<void> modified;
 
 	char filename[512] = {0};
@@ -0,0 +1,620 @@
+/*
+** bundle.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "bundle.h"
+#include "boost-hash.h"
+#include "debugwriter.h"
+
+#include <SDL_rwops.h>
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include "emscripten.hpp"
+#elif !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define BUNDLE_MMAP
+#endif
+
+#define BUNDLE_MAGIC "MKXPBNDL"
+#define BUNDLE_VERSION 1
+
+#define PHYSFS_ALLOC(type) \
+	static_cast<type*>(PHYSFS_getAllocator()->Malloc(sizeof(type)))
+
+struct Bundle_entryData
+{
+	std::string key;
+	uint16_t blob;
+	uint64_t offset;
+	uint64_t size;
+	uint64_t hash;
+
+	bool operator<(const std::string &other) const
+	{
+		return key < other;
+	}
+};
+
+struct Bundle_blob
+{
+	std::string path;
+
+	/* Whole blob, if mapped */
+	const uint8_t *map;
+	size_t mapSize;
+
+	Bundle_blob()
+	    : map(0), mapSize(0)
+	{}
+};
+
+/* Byte wise, so non-ASCII (eg. Japanese) names pass through
+ * unchanged, matching the lower casing done by mkxp-pack */
+static std::string lowerCase(const char *str)
+{
+	std::string result(str);
+
+	for (size_t i = 0; i < result.size(); ++i)
+		result[i] = tolower((unsigned char) result[i]);
+
+	return result;
+}
+
+struct Bundle_archiveData
+{
+	PHYSFS_Io *indexIo;
+
+	std::vector<Bundle_blob> blobs;
+
+	/* Sorted by key */
+	std::vector<Bundle_entryData> entries;
+
+	/* Maps: lower case directory path,
+	 * to:   list of contained entries */
+	BoostHash<std::string, BoostSet<std::string> > dirHash;
+
+#ifdef __EMSCRIPTEN__
+	/* Maps: index into 'entries',
+	 * to:   its contents, fetched on first open. Kept like
+	 *       any other file loaded on the web, so opening it
+	 *       again doesn't go over the network */
+	BoostHash<size_t, uint8_t*> fetched;
+#endif
+
+	const Bundle_entryData *find(const char *filename) const
+	{
+		const std::string key = lowerCase(filename);
+
+		std::vector<Bundle_entryData>::const_iterator iter =
+			std::lower_bound(entries.begin(), entries.end(), key);
+
+		if (iter == entries.end() || iter->key != key)
+			return 0;
+
+		return &*iter;
+	}
+
+	~Bundle_archiveData()
+	{
+#ifdef BUNDLE_MMAP
+		for (size_t i = 0; i < blobs.size(); ++i)
+			if (blobs[i].map)
+				munmap((void*) blobs[i].map, blobs[i].mapSize);
+#endif
+
+#ifdef __EMSCRIPTEN__
+		BoostHash<size_t, uint8_t*>::const_iterator iter;
+		for (iter = fetched.cbegin(); iter != fetched.cend(); ++iter)
+			free(iter->second);
+#endif
+
+		if (indexIo)
+			indexIo->destroy(indexIo);
+	}
+};
+
+struct Bundle_entryHandle
+{
+	const uint8_t *data;
+	uint64_t size;
+	uint64_t offset;
+
+	/* Fetched (rather than mapped) data is ours to free */
+	bool ownsData;
+
+	Bundle_entryHandle(const uint8_t *data, uint64_t size, bool ownsData)
+	    : data(data),
+	      size(size),
+	      offset(0),
+	      ownsData(ownsData)
+	{}
+
+	~Bundle_entryHandle()
+	{
+		if (ownsData)
+			free((void*) data);
+	}
+};
+
+static PHYSFS_sint64
+Bundle_ioRead(PHYSFS_Io *self, void *buffer, PHYSFS_uint64 len)
+{
+	Bundle_entryHandle *entry = static_cast<Bundle_entryHandle*>(self->opaque);
+
+	uint64_t toRead = std::min<uint64_t>(entry->size - entry->offset, len);
+
+	memcpy(buffer, entry->data + entry->offset, toRead);
+	entry->offset += toRead;
+
+	return toRead;
+}
+
+static int
+Bundle_ioSeek(PHYSFS_Io *self, PHYSFS_uint64 offset)
+{
+	Bundle_entryHandle *entry = static_cast<Bundle_entryHandle*>(self->opaque);
+
+	if (offset > entry->size)
+		return 0;
+
+	entry->offset = offset;
+
+	return 1;
+}
+
+static PHYSFS_sint64
+Bundle_ioTell(PHYSFS_Io *self)
+{
+	const Bundle_entryHandle *entry = static_cast<Bundle_entryHandle*>(self->opaque);
+
+	return entry->offset;
+}
+
+static PHYSFS_sint64
+Bundle_ioLength(PHYSFS_Io *self)
+{
+	const Bundle_entryHandle *entry = static_cast<Bundle_entryHandle*>(self->opaque);
+
+	return entry->size;
+}
+
+static PHYSFS_Io*
+Bundle_ioDuplicate(PHYSFS_Io *self)
+{
+	const Bundle_entryHandle *entry = static_cast<Bundle_entryHandle*>(self->opaque);
+	const uint8_t *data = entry->data;
+
+	if (entry->ownsData)
+	{
+		uint8_t *copy = static_cast<uint8_t*>(malloc(std::max<uint64_t>(entry->size, 1)));
+		memcpy(copy, entry->data, entry->size);
+		data = copy;
+	}
+
+	Bundle_entryHandle *entryDup =
+		new Bundle_entryHandle(data, entry->size, entry->ownsData);
+
+	PHYSFS_Io *dup = PHYSFS_ALLOC(PHYSFS_Io);
+	*dup = *self;
+	dup->opaque = entryDup;
+
+	return dup;
+}
+
+static void
+Bundle_ioDestroy(PHYSFS_Io *self)
+{
+	Bundle_entryHandle *entry = static_cast<Bundle_entryHandle*>(self->opaque);
+
+	delete entry;
+
+	PHYSFS_getAllocator()->Free(self);
+}
+
+static const PHYSFS_Io Bundle_IoTemplate =
+{
+	0, /* version */
+	0, /* opaque */
+	Bundle_ioRead,
+	0, /* write */
+	Bundle_ioSeek,
+	Bundle_ioTell,
+	Bundle_ioLength,
+	Bundle_ioDuplicate,
+	0, /* flush */
+	Bundle_ioDestroy
+};
+
+static bool
+readLE(PHYSFS_Io *io, uint64_t &result, int bytes)
+{
+	uint8_t buff[8];
+
+	if (io->read(io, buff, bytes) != bytes)
+		return false;
+
+	result = 0;
+
+	for (int i = bytes-1; i >= 0; --i)
+		result = (result << 8) | buff[i];
+
+	return true;
+}
+
+static void
+addDirectories(Bundle_archiveData *data, std::string path)
+{
+	while (true)
+	{
+		size_t slash = path.rfind('/');
+
+		std::string dir, name;
+
+		if (slash == std::string::npos)
+		{
+			name = path;
+		}
+		else
+		{
+			dir = path.substr(0, slash);
+			name = path.substr(slash+1);
+		}
+
+		BoostSet<std::string> &entryList = data->dirHash[dir];
+
+		/* Parents were already registered along with this one */
+		if (entryList.contains(name))
+			break;
+
+		entryList.insert(name);
+
+		if (slash == std::string::npos)
+			break;
+
+		path = dir;
+	}
+}
+
+static bool
+mapBlob(Bundle_blob &blob)
+{
+#ifdef BUNDLE_MMAP
+	int fd = open(blob.path.c_str(), O_RDONLY);
+
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+
+	if (fstat(fd, &st) != 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	blob.mapSize = st.st_size;
+
+	if (blob.mapSize > 0)
+	{
+		void *map = mmap(0, blob.mapSize, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (map != MAP_FAILED)
+			blob.map = static_cast<const uint8_t*>(map);
+	}
+
+	close(fd);
+
+	return blob.map || blob.mapSize == 0;
+#else
+	(void) blob;
+
+	return true;
+#endif
+}
+
+static void*
+Bundle_openArchive(PHYSFS_Io *io, const char *name, int forWrite, int *claimed)
+{
+	if (forWrite)
+		return NULL;
+
+	char magic[8];
+
+	if (io->read(io, magic, sizeof(magic)) != sizeof(magic) ||
+	    memcmp(magic, BUNDLE_MAGIC, sizeof(magic)))
+		return NULL;
+
+	*claimed = 1;
+
+	uint64_t version, blobCount, entryCount;
+
+	if (!readLE(io, version, 4) || version != BUNDLE_VERSION ||
+	    !readLE(io, blobCount, 4) || !readLE(io, entryCount, 4))
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+		return NULL;
+	}
+
+	Bundle_archiveData *data = new Bundle_archiveData;
+	data->indexIo = io;
+	data->entries.resize(entryCount);
+	data->blobs.resize(blobCount);
+
+	/* Blobs live next to the index */
+	std::string dir(name);
+	size_t slash = dir.rfind('/');
+	dir = (slash == std::string::npos) ? "" : dir.substr(0, slash+1);
+
+	for (size_t i = 0; i < blobCount; ++i)
+	{
+		char blobName[32];
+		snprintf(blobName, sizeof(blobName), "%u.mkxpd", (unsigned) i);
+		data->blobs[i].path = dir + blobName;
+
+		if (!mapBlob(data->blobs[i]))
+		{
+			Debug() << "Bundle: Failed mapping" << data->blobs[i].path;
+			goto error;
+		}
+	}
+
+	for (size_t i = 0; i < entryCount; ++i)
+	{
+		Bundle_entryData &entry = data->entries[i];
+		uint64_t keyLen, blob;
+		char keyBuf[512];
+
+		if (!readLE(io, keyLen, 2) || keyLen >= sizeof(keyBuf) ||
+		    io->read(io, keyBuf, keyLen) != (PHYSFS_sint64) keyLen)
+			goto error;
+
+		entry.key.assign(keyBuf, keyLen);
+
+		if (!readLE(io, blob, 2) || blob >= blobCount ||
+		    !readLE(io, entry.offset, 8) ||
+		    !readLE(io, entry.size, 8) ||
+		    !readLE(io, entry.hash, 8))
+			goto error;
+
+		entry.blob = blob;
+
+		const Bundle_blob &b = data->blobs[blob];
+
+		if (b.map && entry.offset + entry.size > b.mapSize)
+			goto error;
+
+		if (i > 0 && !(data->entries[i-1].key < entry.key))
+			goto error;
+
+		addDirectories(data, entry.key);
+
+#ifdef __EMSCRIPTEN__
+		/* Served from here from now on, so never fetch the loose file */
+		bundle_mark_cached_js(entry.key.c_str());
+#endif
+	}
+
+	/* Make sure the root exists even for an empty bundle */
+	data->dirHash[""];
+
+	return data;
+
+error:
+	PHYSFS_setErrorCode(PHYSFS_ERR_CORRUPT);
+
+	/* The io stays with the caller on failure */
+	data->indexIo = 0;
+	delete data;
+
+	return NULL;
+}
+
+static PHYSFS_EnumerateCallbackResult
+Bundle_enumerateFiles(void *opaque, const char *dirname,
+                      PHYSFS_EnumerateCallback cb,
+                      const char *origdir, void *callbackdata)
+{
+	Bundle_archiveData *data = static_cast<Bundle_archiveData*>(opaque);
+
+	const std::string _dirname = lowerCase(dirname);
+
+	if (!data->dirHash.contains(_dirname))
+		return PHYSFS_ENUM_STOP;
+
+	const BoostSet<std::string> &entries = data->dirHash[_dirname];
+
+	BoostSet<std::string>::const_iterator iter;
+	for (iter = entries.cbegin(); iter != entries.cend(); ++iter)
+		if (cb(callbackdata, origdir, iter->c_str()) != PHYSFS_ENUM_OK)
+			return PHYSFS_ENUM_STOP;
+
+	return PHYSFS_ENUM_OK;
+}
+
+static PHYSFS_Io*
+Bundle_openRead(void *opaque, const char *filename)
+{
+	Bundle_archiveData *data = static_cast<Bundle_archiveData*>(opaque);
+
+	const Bundle_entryData *entry = data->find(filename);
+
+	if (!entry)
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return 0;
+	}
+
+	const Bundle_blob &blob = data->blobs[entry->blob];
+	Bundle_entryHandle *handle;
+
+	if (blob.map)
+	{
+		handle = new Bundle_entryHandle(blob.map + entry->offset, entry->size, false);
+	}
+#ifdef __EMSCRIPTEN__
+	else if (entry->size > 0)
+	{
+		const size_t index = entry - &data->entries[0];
+
+		if (!data->fetched.contains(index))
+		{
+			uint8_t *buffer = static_cast<uint8_t*>(
+				bundle_fetch_range_js(blob.path.c_str(), entry->offset, entry->size));
+
+			if (!buffer)
+			{
+				PHYSFS_setErrorCode(PHYSFS_ERR_IO);
+				return 0;
+			}
+
+			data->fetched.insert(index, buffer);
+		}
+
+		handle = new Bundle_entryHandle(data->fetched[index], entry->size, false);
+	}
+#endif
+	else
+	{
+		uint8_t *buffer = 0;
+
+		if (entry->size == 0)
+		{
+			buffer = static_cast<uint8_t*>(malloc(1));
+		}
+		else
+		{
+			SDL_RWops *ops = SDL_RWFromFile(blob.path.c_str(), "rb");
+
+			if (ops)
+			{
+				buffer = static_cast<uint8_t*>(malloc(entry->size));
+
+				if (SDL_RWseek(ops, entry->offset, RW_SEEK_SET) < 0 ||
+				    SDL_RWread(ops, buffer, 1, entry->size) != entry->size)
+				{
+					free(buffer);
+					buffer = 0;
+				}
+
+				SDL_RWclose(ops);
+			}
+		}
+
+		if (!buffer)
+		{
+			PHYSFS_setErrorCode(PHYSFS_ERR_IO);
+			return 0;
+		}
+
+		handle = new Bundle_entryHandle(buffer, entry->size, true);
+	}
+
+	PHYSFS_Io *io = PHYSFS_ALLOC(PHYSFS_Io);
+
+	*io = Bundle_IoTemplate;
+	io->opaque = handle;
+
+	return io;
+}
+
+static int
+Bundle_stat(void *opaque, const char *filename, PHYSFS_Stat *stat)
+{
+	Bundle_archiveData *data = static_cast<Bundle_archiveData*>(opaque);
+
+	const Bundle_entryData *entry = data->find(filename);
+
+	const std::string dir = lowerCase(filename);
+
+	if (!entry && !data->dirHash.contains(dir))
+	{
+		PHYSFS_setErrorCode(PHYSFS_ERR_NOT_FOUND);
+		return 0;
+	}
+
+	stat->modtime    =
+	stat->createtime =
+	stat->accesstime = 0;
+	stat->readonly   = 1;
+
+	if (entry)
+	{
+		stat->filesize = entry->size;
+		stat->filetype = PHYSFS_FILETYPE_REGULAR;
+	}
+	else
+	{
+		stat->filesize = 0;
+		stat->filetype = PHYSFS_FILETYPE_DIRECTORY;
+	}
+
+	return 1;
+}
+
+static void
+Bundle_closeArchive(void *opaque)
+{
+	Bundle_archiveData *data = static_cast<Bundle_archiveData*>(opaque);
+
+	delete data;
+}
+
+static PHYSFS_Io*
+Bundle_noop1(void*, const char*)
+{
+	return 0;
+}
+
+static int
+Bundle_noop2(void*, const char*)
+{
+	return 0;
+}
+
+const PHYSFS_Archiver Bundle_Archiver =
+{
+	0,
+	{
+		"MKXPB",
+		"mkxp asset bundle",
+		"", /* Author */
+		"", /* Website */
+		0 /* symlinks not supported */
+	},
+	Bundle_openArchive,
+	Bundle_enumerateFiles,
+	Bundle_openRead,
+	Bundle_noop1, /* openWrite */
+	Bundle_noop1, /* openAppend */
+	Bundle_noop2, /* remove */
+	Bundle_noop2, /* mkdir */
+	Bundle_stat,
+	Bundle_closeArchive
+};
@@ -0,0 +1,42 @@
+/*
+** bundle.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef BUNDLE_H
+#define BUNDLE_H
+
+#include <physfs.h>
+
+/* Asset bundle as written by 'mkxp-pack --bundle': an index file
+ * plus data blobs "<n>.mkxpd" next to it. All integers are little
+ * endian.
+ *
+ * Index:
+ *   "MKXPBNDL", u32 version (1), u32 blob count, u32 entry count,
+ *   then per entry, sorted bytewise by key:
+ *     u16 key length, key (lower case path),
+ *     u16 blob, u64 offset, u64 length, u64 hash (XXH64)
+ *
+ * Identical files share their blob range. Lookups are case
+ * insensitive. Blobs are memory mapped natively; on the web
+ * every opened entry is fetched as a byte range of its blob */
+#define BUNDLE_INDEX_PATH "Bundle/index.mkxpb"
+
+extern const PHYSFS_Archiver Bundle_Archiver;
+
+#endif // BUNDLE_H
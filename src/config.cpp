@@ -157,6 +157,7 @@ void Config::read(int argc, char *argv[])
 	PO_DESC(rgssVersion, int, 0) \
 	PO_DESC(debugMode, bool, false) \
 	PO_DESC(printFPS, bool, false) \
+	PO_DESC(printRenderStats, bool, false) \
 	PO_DESC(winResizable, bool, false) \
 	PO_DESC(fullscreen, bool, false) \
 	PO_DESC(fixedAspectRatio, bool, true) \
@@ -172,6 +173,7 @@ void Config::read(int argc, char *argv[])
 	PO_DESC(subImageFix, bool, false) \
 	PO_DESC(enableBlitting, bool, true) \
 	PO_DESC(maxTextureSize, int, 0) \
+	PO_DESC(texPoolSize, int, 20) \
 	PO_DESC(gameFolder, std::string, ".") \
 	PO_DESC(anyAltToggleFS, bool, false) \
 	PO_DESC(enableReset, bool, true) \
@@ -185,9 +187,15 @@ void Config::read(int argc, char *argv[])
 	PO_DESC(midi.chorus, bool, false) \
 	PO_DESC(midi.reverb, bool, false) \
 	PO_DESC(SE.sourceCount, int, 6) \
+	PO_DESC(prefetch.enabled, bool, true) \
+	PO_DESC(prefetch.concurrency, int, 4) \
+	PO_DESC(prefetch.budget, int, 32) \
+	PO_DESC(prefetch.source, std::string, "") \
+	PO_DESC(prefetch.latency, int, 100) \
 	PO_DESC(customScript, std::string, "") \
 	PO_DESC(pathCache, bool, true) \
-	PO_DESC(useScriptNames, bool, false)
+	PO_DESC(useScriptNames, bool, false) \
+	PO_DESC(nativeMarshal, bool, true)
 
 	PO_DESC_ALL;
 	gameFolder = "game";
@@ -231,6 +239,12 @@ void Config::read(int argc, char *argv[])
 
 	SE.sourceCount = clamp(SE.sourceCount, 1, 64);
 
+	texPoolSize = clamp(texPoolSize, 0, 1024);
+
+	prefetch.concurrency = clamp(prefetch.concurrency, 1, 16);
+	prefetch.budget = clamp(prefetch.budget, 0, 1024);
+	prefetch.latency = clamp(prefetch.latency, 0, 10000);
+
 	if (!dataPathOrg.empty() && !dataPathApp.empty())
 		customDataPath = prefPath(dataPathOrg.c_str(), dataPathApp.c_str());
 
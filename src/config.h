@@ -32,6 +32,7 @@ struct Config
 
 	bool debugMode;
 	bool printFPS;
+	bool printRenderStats;
 
 	bool winResizable;
 	bool fullscreen;
@@ -52,6 +53,7 @@ struct Config
 	bool subImageFix;
 	bool enableBlitting;
 	int maxTextureSize;
+	int texPoolSize;
 
 	std::string gameFolder;
 	bool anyAltToggleFS;
@@ -78,8 +80,19 @@ struct Config
 		int sourceCount;
 	} SE;
 
+	struct
+	{
+		bool enabled;
+		int concurrency;
+		int budget;
+		std::string source;
+		int latency;
+	} prefetch;
+
 	bool useScriptNames;
 
+	bool nativeMarshal;
+
 	std::string customScript;
 	std::set<std::string> preloadScripts;
 	std::vector<std::string> rtps;
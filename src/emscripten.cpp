@@ -18,5 +18,71 @@ EM_JS(int, file_is_cached, (const char* fullPathC), {
 	return window.fileAsyncCache.hasOwnProperty(mappingKey) ? 1 : 0;
 });
 
+EM_JS(int, file_is_pending, (const char* fullPathC), {
+	const mappingKey = getMappingKey(UTF8ToString(fullPathC));
+	return window.prefetchPending.hasOwnProperty(mappingKey) ? 1 : 0;
+});
+
+EM_JS(void, prefetch_file_js, (const char* fullPathC), {
+	window.prefetchFileAsync(UTF8ToString(fullPathC));
+});
+
+EM_JS(int, prefetch_status_js, (const char* fullPathC), {
+	const fullPath = UTF8ToString(fullPathC);
+	const size = window.prefetchStatus[fullPath];
+	if (size === undefined) return -1;
+	delete window.prefetchStatus[fullPath];
+	return size;
+});
+
+EM_JS(void, prefetch_manifest_js, (const char* mapFileC), {
+	const mapFile = UTF8ToString(mapFileC);
+	fetch("preload/" + mapFile + ".json")
+		.then(function(response) { return response.ok ? response.json() : []; })
+		.catch(function() { return []; })
+		.then(function(list) { window.prefetchManifests[mapFile] = list.join("\n"); });
+});
+
+EM_JS(char*, prefetch_take_manifest_js, (const char* mapFileC), {
+	const mapFile = UTF8ToString(mapFileC);
+	const list = window.prefetchManifests[mapFile];
+	if (list === undefined) return 0;
+	delete window.prefetchManifests[mapFile];
+	const size = lengthBytesUTF8(list) + 1;
+	const ptr = _malloc(size);
+	stringToUTF8(list, ptr, size);
+	return ptr;
+});
+
+EM_JS(void, bundle_mark_cached_js, (const char* fullPathC), {
+	window.fileAsyncCache[getMappingKey(UTF8ToString(fullPathC))] = 1;
+});
+
+EM_JS(void*, bundle_fetch_range_js, (const char* blobPathC, double offset, double length), {
+	return Asyncify.handleSleep(function(wakeUp) {
+		const blobPath = UTF8ToString(blobPathC);
+		const url = "gameasync/" + (mapping[getMappingKey(blobPath)] || blobPath);
+
+		fetch(url, { headers: { Range: "bytes=" + offset + "-" + (offset + length - 1) } })
+			.then(function(response) {
+				if (!response.ok) throw new Error(response.status);
+				// Servers ignoring the range send the whole blob
+				const whole = response.status != 206;
+				return response.arrayBuffer().then(function(buf) {
+					return whole ? buf.slice(offset, offset + length) : buf;
+				});
+			})
+			.then(function(buf) {
+				const ptr = _malloc(length);
+				HEAPU8.set(new Uint8Array(buf), ptr);
+				wakeUp(ptr);
+			})
+			.catch(function(err) {
+				console.error("Failed fetching bundle range", blobPath, err);
+				wakeUp(0);
+			});
+	});
+});
+
 #endif
 
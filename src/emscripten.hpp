@@ -10,6 +10,24 @@ extern "C" {
 	void save_file_async_js(const char* fullPathC);
 
 	int file_is_cached(const char* fullPathC);
+
+	/* Prefetcher; none of these block */
+	int file_is_pending(const char* fullPathC);
+
+	void prefetch_file_js(const char* fullPathC);
+
+	/* -1 while in flight, fetched bytes afterwards */
+	int prefetch_status_js(const char* fullPathC);
+
+	void prefetch_manifest_js(const char* mapFileC);
+
+	/* Newline separated, malloc'ed; null until fetched */
+	char* prefetch_take_manifest_js(const char* mapFileC);
+
+	/* Bundle archiver; the returned buffer is malloc'ed */
+	void bundle_mark_cached_js(const char* fullPathC);
+
+	void* bundle_fetch_range_js(const char* blobPathC, double offset, double length);
 }
 
 #endif
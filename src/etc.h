@@ -32,6 +32,7 @@ struct SDL_Color;
 enum BlendType
 {
 	BlendKeepDestAlpha = -1,
+	BlendPremultiplied = -2,
 
 	BlendNormal = 0,
 	BlendAddition = 1,
@@ -89,6 +90,8 @@ struct Color : public Serializable
 
 	/* Normalized (0.0 ~ 1.0) */
 	Vec4 norm;
+
+	sigc::signal<void> valueChanged;
 };
 
 struct Tone : public Serializable
@@ -22,6 +22,7 @@
 #include "filesystem.h"
 
 #include "rgssad.h"
+#include "bundle.h"
 #include "font.h"
 #include "util.h"
 #include "exception.h"
@@ -345,6 +346,9 @@ FileSystem::FileSystem(const char *argv0,
 	if (er == 0)
 		throwPhysfsError("Error registering PhysFS RGSS archiver");
 
+	if (PHYSFS_registerArchiver(&Bundle_Archiver) == 0)
+		throwPhysfsError("Error registering PhysFS bundle archiver");
+
 	p = new FileSystemPrivate;
 	p->havePathCache = false;
 
@@ -704,7 +708,9 @@ void FileSystem::openReadRaw(SDL_RWops &ops,
                              bool freeOnClose)
 {
 	PHYSFS_File *handle = PHYSFS_openRead(filename);
-	assert(handle);
+
+	if (!handle)
+		throw Exception(Exception::NoFileError, "%s", filename);
 
 	initReadOps(handle, ops, freeOnClose);
 }
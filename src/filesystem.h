@@ -59,7 +59,8 @@ public:
 	void openRead(OpenHandler &handler,
 	              const char *filename);
 
-	/* Circumvents extension supplementing */
+	/* Circumvents extension supplementing;
+	 * throws NoFileError if 'filename' doesn't exist */
 	void openReadRaw(SDL_RWops &ops,
 	                 const char *filename,
 	                 bool freeOnClose = false);
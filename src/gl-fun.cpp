@@ -163,6 +163,36 @@ void initGLFunctions()
 		GL_VAO_FUN;
 	}
 
+	/* Program binary entrypoints */
+	if (HAVE_EXT(ARB_get_program_binary) || (gles && glMajor >= 3))
+	{
+#undef EXT_SUFFIX
+#define EXT_SUFFIX ""
+		GL_PROGRAM_BINARY_FUN;
+		GL_PROGRAM_PARAMETER_FUN;
+	}
+	else if (HAVE_EXT(OES_get_program_binary))
+	{
+#undef EXT_SUFFIX
+#define EXT_SUFFIX "OES"
+		GL_PROGRAM_BINARY_FUN;
+	}
+
+	/* Some drivers expose the entrypoints
+	 * without supporting a single format */
+	if (gl.GetProgramBinary)
+	{
+		GLint formats = 0;
+		gl.GetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+
+		if (formats == 0)
+		{
+			gl.GetProgramBinary = 0;
+			gl.ProgramBinary = 0;
+			gl.ProgramParameteri = 0;
+		}
+	}
+
 	/* Debug callback entrypoints */
 	if (HAVE_EXT(KHR_debug))
 	{
@@ -144,7 +144,7 @@ static void _blitBegin(FBO::ID fbo, const Vec2i &size)
 		FBO::bind(fbo);
 		glState.viewport.pushSet(IntRect(0, 0, size.x, size.y));
 
-		SimpleShader &shader = shState->shaders().simple;
+		SimpleShader &shader = shState->shaders().simple();
 		shader.bind();
 		shader.applyViewportProj();
 		shader.setTranslation(Vec2i());
@@ -169,7 +169,7 @@ void blitSource(TEXFBO &source)
 	}
 	else
 	{
-		SimpleShader &shader = shState->shaders().simple;
+		SimpleShader &shader = shState->shaders().simple();
 		shader.setTexSize(Vec2i(source.width, source.height));
 		TEX::bind(source.tex);
 	}
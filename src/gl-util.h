@@ -53,6 +53,17 @@ namespace TEX
 {
 	DEF_GL_ID
 
+	/* Tracks the texture bound to unit 0 so redundant
+	 * rebinds can be skipped (defined in glstate.cpp) */
+	struct Binding
+	{
+		GLuint current;
+		unsigned int applied;
+		unsigned int avoided;
+	};
+
+	extern Binding binding;
+
 	inline ID gen()
 	{
 		ID id;
@@ -63,12 +74,24 @@ namespace TEX
 
 	static inline void del(ID id)
 	{
+		/* Deleting a bound texture reverts the binding to 0 */
+		if (binding.current == id.gl)
+			binding.current = 0;
+
 		gl.DeleteTextures(1, &id.gl);
 	}
 
 	static inline void bind(ID id)
 	{
+		if (id.gl == binding.current)
+		{
+			++binding.avoided;
+			return;
+		}
+
 		gl.BindTexture(GL_TEXTURE_2D, id.gl);
+		binding.current = id.gl;
+		++binding.applied;
 	}
 
 	static inline void unbind()
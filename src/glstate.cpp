@@ -23,10 +23,13 @@
 #include "shader.h"
 #include "etc.h"
 #include "gl-fun.h"
+#include "gl-util.h"
 #include "config.h"
 
 #include <SDL_rect.h>
 
+TEX::Binding TEX::binding = { 0, 0, 0 };
+
 static void applyBool(GLenum state, bool mode)
 {
 	mode ? gl.Enable(state) : gl.Disable(state);
@@ -71,6 +74,12 @@ void GLBlendMode::apply(const BlendType &value)
 		                     GL_ZERO,      GL_ONE);
 		break;
 
+	case BlendPremultiplied :
+		gl.BlendEquation(GL_FUNC_ADD);
+		gl.BlendFuncSeparate(GL_ONE, GL_ONE_MINUS_SRC_ALPHA,
+		                     GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		break;
+
 	case BlendNormal :
 		gl.BlendEquation(GL_FUNC_ADD);
 		gl.BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
@@ -125,3 +134,28 @@ GLState::GLState(const Config &conf)
 	if (conf.maxTextureSize > 0)
 		caps.maxTexSize = conf.maxTextureSize;
 }
+
+template<typename T>
+static void collectStats(GLProperty<T> &prop, GLState::Stats &stats)
+{
+	stats.changes += prop.applied;
+	stats.avoided += prop.avoided;
+
+	prop.applied = prop.avoided = 0;
+}
+
+GLState::Stats GLState::takeStats()
+{
+	Stats stats = { TEX::binding.applied, TEX::binding.avoided };
+	TEX::binding.applied = TEX::binding.avoided = 0;
+
+	collectStats(clearColor, stats);
+	collectStats(scissorBox, stats);
+	collectStats(scissorTest, stats);
+	collectStats(blendMode, stats);
+	collectStats(blend, stats);
+	collectStats(viewport, stats);
+	collectStats(program, stats);
+
+	return stats;
+}
@@ -37,6 +37,11 @@ struct GLProperty
 		assert(stack.size() == 0);
 	}
 
+	GLProperty()
+	    : applied(0),
+	      avoided(0)
+	{}
+
 	void init(const T &value)
 	{
 		current = value;
@@ -49,9 +54,13 @@ struct GLProperty
 	void set(const T &value)
 	{
 		if (value == current)
+		{
+			++avoided;
 			return;
+		}
 
 		init(value);
+		++applied;
 	}
 
 	void pushSet(const T &value)
@@ -64,6 +73,12 @@ struct GLProperty
 	{
 		apply(current);
 	}
+
+	/* Number of state changes sent to GL / skipped
+	 * because the value was already current */
+	unsigned int applied;
+	unsigned int avoided;
+
 private:
 	virtual void apply(const T &value) = 0;
 
@@ -132,7 +147,17 @@ public:
 
 	} caps;
 
+	struct Stats
+	{
+		unsigned int changes;
+		unsigned int avoided;
+	};
+
 	GLState(const Config &conf);
+
+	/* Returns the state changes applied and avoided
+	 * since the last call, and resets the counters */
+	Stats takeStats();
 };
 
 #endif // GLSTATE_H
@@ -31,7 +31,9 @@
 #include "quad.h"
 #include "eventthread.h"
 #include "texpool.h"
+#include "prefetcher.h"
 #include "bitmap.h"
+#include "table.h"
 #include "etc-internal.h"
 #include "disposable.h"
 #include "intrulist.h"
@@ -150,6 +152,7 @@ public:
 		const int w = geometry.rect.w;
 		const int h = geometry.rect.h;
 
+		Table::emitModified();
 		shState->prepareDraw();
 
 		pp.startRender();
@@ -162,7 +165,7 @@ public:
 
 		if (brightEffect)
 		{
-			SimpleColorShader &shader = shState->shaders().simpleColor;
+			SimpleColorShader &shader = shState->shaders().simpleColor();
 			shader.bind();
 			shader.applyViewportProj();
 			shader.setTranslation(Vec2i());
@@ -171,114 +174,67 @@ public:
 		}
 	}
 
+	void bindRenderTarget()
+	{
+		pp.startRender();
+	}
+
 	void requestViewportRender(const Vec4 &c, const Vec4 &f, const Vec4 &t)
 	{
+		const bool toneEffect  = t.xyzNotNull() || t.w != 0;
+		const bool colorEffect = c.w > 0;
+		const bool flashEffect = f.w > 0;
+
+		if (!toneEffect && !colorEffect && !flashEffect)
+			return;
+
+		/* Only the on screen part of the viewport is affected */
 		const IntRect &viewpRect = glState.scissorBox.get();
 		const IntRect &screenRect = geometry.rect;
 
-		const bool toneRGBEffect  = t.xyzNotNull();
-		const bool toneGrayEffect = t.w != 0;
-		const bool colorEffect    = c.w > 0;
-		const bool flashEffect    = f.w > 0;
+		IntRect rect;
+		rect.x = std::max(viewpRect.x, screenRect.x);
+		rect.y = std::max(viewpRect.y, screenRect.y);
+		rect.w = std::min(viewpRect.x+viewpRect.w, screenRect.x+screenRect.w) - rect.x;
+		rect.h = std::min(viewpRect.y+viewpRect.h, screenRect.y+screenRect.h) - rect.y;
 
-		if (toneGrayEffect)
-		{
-			pp.swapRender();
-
-			if (!viewpRect.encloses(screenRect))
-			{
-				/* Scissor test _does_ affect FBO blit operations,
-				 * and since we're inside the draw cycle, it will
-				 * be turned on, so turn it off temporarily */
-				glState.scissorTest.pushSet(false);
+		if (rect.w <= 0 || rect.h <= 0)
+			return;
 
-				GLMeta::blitBegin(pp.frontBuffer());
-				GLMeta::blitSource(pp.backBuffer());
-				GLMeta::blitRectangle(geometry.rect, Vec2i());
-				GLMeta::blitEnd();
+		/* Copy the area out so the effect shader can read
+		 * it while drawing over it. Scissor test _does_ affect
+		 * FBO blit operations, and since we're inside the draw
+		 * cycle, it will be turned on, so turn it off temporarily */
+		TEXFBO &src = shState->gpTexFBO(rect.w, rect.h);
 
-				glState.scissorTest.pop();
-			}
+		glState.scissorTest.pushSet(false);
 
-			GrayShader &shader = shState->shaders().gray;
-			shader.bind();
-			shader.setGray(t.w);
-			shader.applyViewportProj();
-			shader.setTexSize(screenRect.size());
+		GLMeta::blitBegin(src);
+		GLMeta::blitSource(pp.frontBuffer());
+		GLMeta::blitRectangle(rect, Vec2i());
+		GLMeta::blitEnd();
 
-			TEX::bind(pp.backBuffer().tex);
+		glState.scissorTest.pop();
 
-			glState.blend.pushSet(false);
-			screenQuad.draw();
-			glState.blend.pop();
-		}
-
-		if (!toneRGBEffect && !colorEffect && !flashEffect)
-			return;
+		pp.startRender();
 
-		FlatColorShader &shader = shState->shaders().flatColor;
+		ViewportShader &shader = shState->shaders().viewport();
 		shader.bind();
 		shader.applyViewportProj();
+		shader.setTranslation(Vec2i());
+		shader.setTexSize(Vec2i(src.width, src.height));
+		shader.setTone(t);
+		shader.setColor(c);
+		shader.setFlash(f);
 
-		if (toneRGBEffect)
-		{
-			/* First split up additive / substractive components */
-			Vec4 add, sub;
-
-			if (t.x > 0)
-				add.x = t.x;
-			if (t.y > 0)
-				add.y = t.y;
-			if (t.z > 0)
-				add.z = t.z;
-
-			if (t.x < 0)
-				sub.x = -t.x;
-			if (t.y < 0)
-				sub.y = -t.y;
-			if (t.z < 0)
-				sub.z = -t.z;
-
-			/* Then apply them using hardware blending */
-			gl.BlendFuncSeparate(GL_ONE, GL_ONE, GL_ZERO, GL_ONE);
-
-			if (add.xyzNotNull())
-			{
-				gl.BlendEquation(GL_FUNC_ADD);
-				shader.setColor(add);
-
-				screenQuad.draw();
-			}
-
-			if (sub.xyzNotNull())
-			{
-				gl.BlendEquation(GL_FUNC_REVERSE_SUBTRACT);
-				shader.setColor(sub);
-
-				screenQuad.draw();
-			}
-		}
-
-		if (colorEffect || flashEffect)
-		{
-			gl.BlendEquation(GL_FUNC_ADD);
-			gl.BlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA,
-			                     GL_ZERO, GL_ONE);
-		}
-
-		if (colorEffect)
-		{
-			shader.setColor(c);
-			screenQuad.draw();
-		}
+		TEX::bind(src.tex);
 
-		if (flashEffect)
-		{
-			shader.setColor(f);
-			screenQuad.draw();
-		}
+		Quad &quad = shState->gpQuad();
+		quad.setTexPosRect(FloatRect(0, 0, rect.w, rect.h), rect);
 
-		glState.blendMode.refresh();
+		glState.blend.pushSet(false);
+		quad.draw();
+		glState.blend.pop();
 	}
 
 	void setBrightness(float norm)
@@ -293,7 +249,6 @@ public:
 		geometry.rect.w = width;
 		geometry.rect.h = height;
 
-		screenQuad.setTexPosRect(geometry.rect, geometry.rect);
 		brightnessQuad.setTexPosRect(geometry.rect, geometry.rect);
 
 		notifyGeometryChange();
@@ -312,7 +267,6 @@ public:
 
 private:
 	PingPong pp;
-	Quad screenQuad;
 
 	Quad brightnessQuad;
 	bool brightEffect;
@@ -480,6 +434,10 @@ struct GraphicsPrivate
 	TEXFBO frozenScene;
 	Quad screenQuad;
 
+	/* Last time render statistics were printed */
+	uint32_t statsTicks;
+	unsigned int statsFrames;
+
 	/* Global list of all live Disposables
 	 * (disposed on reset) */
 	IntruList<Disposable> dispList;
@@ -495,7 +453,9 @@ struct GraphicsPrivate
 	      frameCount(0),
 	      brightness(255),
 	      fpsLimiter(frameRate),
-	      frozen(false)
+	      frozen(false),
+	      statsTicks(0),
+	      statsFrames(0)
 	{
 		recalculateScreenSize(rtData);
 		updateScreenResoRatio(rtData);
@@ -583,6 +543,44 @@ struct GraphicsPrivate
 		++frameCount;
 
 		threadData->ethread->notifyFrame();
+
+		if (threadData->config.printRenderStats)
+			printRenderStats();
+	}
+
+	void printRenderStats()
+	{
+		uint32_t ticks = SDL_GetTicks();
+		++statsFrames;
+
+		if (ticks - statsTicks < 1000)
+			return;
+
+		statsTicks = ticks;
+
+		TexPool::Stats tp = shState->texPool().getStats();
+
+		Debug() << "TexPool: hit rate" << (int) (tp.hitRate() * 100) << "%,"
+		        << tp.objCount << "objects," << tp.memSize / 1024 << "KB cached,"
+		        << tp.allocsPerSec << "allocs/s";
+
+		GLState::Stats gs = glState.takeStats();
+
+		Debug() << "GL state:" << gs.changes / statsFrames << "changes,"
+		        << gs.avoided / statsFrames << "avoided per frame";
+
+		Scene::CullStats cs = Scene::takeCullStats();
+
+		Debug() << "Culling:" << cs.offScreen / statsFrames << "off screen,"
+		        << cs.occluded / statsFrames << "occluded per frame";
+
+		Prefetcher::Stats ps = shState->prefetcher().takeStats();
+
+		Debug() << "Prefetch:" << ps.hits << "hits," << ps.misses << "misses,"
+		        << ps.issued << "issued," << ps.dropped << "dropped,"
+		        << ps.bytes / 1024 << "KB fetched ahead";
+
+		statsFrames = 0;
 	}
 
 	void compositeToBuffer(TEXFBO &buffer)
@@ -662,6 +660,8 @@ void Graphics::update()
 	p->checkShutDownReset();
 	p->checkSyncLock();
 
+	shState->prefetcher().update();
+
 	if (p->frozen)
 		return;
 
@@ -708,7 +708,25 @@ void Graphics::transition(int duration,
 		return;
 
 	vague = clamp(vague, 1, 256);
-	Bitmap *transMap = *filename ? new Bitmap(filename) : 0;
+
+	/* The transition shader samples all of its textures with the
+	 * same coordinates, so the map is copied into a texture of its
+	 * exact size (pooled bitmap textures may be bigger) */
+	TEXFBO transMap;
+
+	if (*filename)
+	{
+		Bitmap transBitmap(filename);
+
+		TEXFBO::init(transMap);
+		TEXFBO::allocEmpty(transMap, transBitmap.width(), transBitmap.height());
+		TEXFBO::linkFBO(transMap);
+
+		GLMeta::blitBegin(transMap);
+		GLMeta::blitSource(transBitmap.getGLTypes());
+		GLMeta::blitRectangle(transBitmap.rect(), Vec2i());
+		GLMeta::blitEnd();
+	}
 
 	setBrightness(255);
 
@@ -724,23 +742,20 @@ void Graphics::transition(int duration,
 
 	/* If no transition bitmap is provided,
 	 * we can use a simplified shader */
-	TransShader &transShader = shState->shaders().trans;
-	SimpleTransShader &simpleShader = shState->shaders().simpleTrans;
-
-	if (transMap)
+	if (transMap.tex != TEX::ID(0))
 	{
-		TransShader &shader = transShader;
+		TransShader &shader = shState->shaders().trans();
 		shader.bind();
 		shader.applyViewportProj();
 		shader.setFrozenScene(p->frozenScene.tex);
 		shader.setCurrentScene(currentScene.tex);
-		shader.setTransMap(transMap->getGLTypes().tex);
+		shader.setTransMap(transMap.tex);
 		shader.setVague(vague / 256.0f);
 		shader.setTexSize(p->scRes);
 	}
 	else
 	{
-		SimpleTransShader &shader = simpleShader;
+		SimpleTransShader &shader = shState->shaders().simpleTrans();
 		shader.bind();
 		shader.applyViewportProj();
 		shader.setFrozenScene(p->frozenScene.tex);
@@ -759,7 +774,7 @@ void Graphics::transition(int duration,
 		if (p->threadData->rqTerm)
 		{
 			glState.blend.pop();
-			delete transMap;
+			TEXFBO::fini(transMap);
 			p->shutdown();
 			return;
 		}
@@ -767,7 +782,7 @@ void Graphics::transition(int duration,
 		if (p->threadData->rqReset)
 		{
 			glState.blend.pop();
-			delete transMap;
+			TEXFBO::fini(transMap);
 			scriptBinding->reset();
 			return;
 		}
@@ -776,15 +791,17 @@ void Graphics::transition(int duration,
 
 		const float prog = i * (1.0f / duration);
 
-		if (transMap)
+		if (transMap.tex != TEX::ID(0))
 		{
-			transShader.bind();
-			transShader.setProg(prog);
+			TransShader &shader = shState->shaders().trans();
+			shader.bind();
+			shader.setProg(prog);
 		}
 		else
 		{
-			simpleShader.bind();
-			simpleShader.setProg(prog);
+			SimpleTransShader &shader = shState->shaders().simpleTrans();
+			shader.bind();
+			shader.setProg(prog);
 		}
 
 		/* Draw the composed frame to a buffer first
@@ -813,7 +830,7 @@ void Graphics::transition(int duration,
 
 	glState.blend.pop();
 
-	delete transMap;
+	TEXFBO::fini(transMap);
 
 	p->frozen = false;
 }
@@ -44,12 +44,18 @@ static float fwrap(float value, float range)
 
 struct PlanePrivate
 {
+	Plane *self;
+
 	Bitmap *bitmap;
+	sigc::connection bitmapCon;
+	sigc::connection bitmapDispCon;
 
 	NormValue opacity;
 	BlendType blendType;
 	Color *color;
 	Tone *tone;
+	sigc::connection colorCon;
+	sigc::connection toneCon;
 
 	int ox, oy;
 	float zoomX, zoomY;
@@ -64,8 +70,9 @@ struct PlanePrivate
 
 	sigc::connection prepareCon;
 
-	PlanePrivate()
-	    : bitmap(0),
+	PlanePrivate(Plane *self)
+	    : self(self),
+	      bitmap(0),
 	      opacity(255),
 	      blendType(BlendNormal),
 	      color(&tmp.color),
@@ -77,18 +84,69 @@ struct PlanePrivate
 		prepareCon = shState->prepareDraw.connect
 		        (sigc::mem_fun(this, &PlanePrivate::prepare));
 
+		updateColorToneCons();
+
 		qArray.resize(1);
 	}
 
 	~PlanePrivate()
 	{
+		colorCon.disconnect();
+		toneCon.disconnect();
+		bitmapCon.disconnect();
+		bitmapDispCon.disconnect();
 		prepareCon.disconnect();
 	}
 
+	void notifyChange()
+	{
+		self->notifyChange();
+	}
+
+	void updateColorToneCons()
+	{
+		colorCon.disconnect();
+		colorCon = color->valueChanged.connect
+				(sigc::mem_fun(this, &PlanePrivate::notifyChange));
+
+		toneCon.disconnect();
+		toneCon = tone->valueChanged.connect
+				(sigc::mem_fun(this, &PlanePrivate::notifyChange));
+	}
+
+	void updateBitmapCons()
+	{
+		bitmapCon.disconnect();
+		bitmapDispCon.disconnect();
+
+		if (nullOrDisposed(bitmap))
+			return;
+
+		bitmapCon = bitmap->modified.connect
+				(sigc::mem_fun(this, &PlanePrivate::notifyChange));
+		bitmapDispCon = bitmap->wasDisposed.connect
+				(sigc::mem_fun(this, &PlanePrivate::notifyChange));
+	}
+
+	/* Hardware repeat only wraps correctly if the bitmap
+	 * fills its (pooled) texture exactly */
+	bool useRepeat() const
+	{
+		if (!gl.npot_repeat || nullOrDisposed(bitmap))
+			return false;
+
+		const TEXFBO &tex = bitmap->getGLTypes();
+
+		return tex.width == bitmap->width() && tex.height == bitmap->height();
+	}
+
 	void updateQuadSource()
 	{
-		if (gl.npot_repeat)
+		if (useRepeat())
 		{
+			qArray.resize(1);
+			Quad::setPosRect(&qArray.vertices[0], FloatRect(sceneGeo.rect));
+
 			FloatRect srcRect;
 			srcRect.x = (sceneGeo.orig.x + ox) / zoomX;
 			srcRect.y = (sceneGeo.orig.y + oy) / zoomY;
@@ -149,7 +207,7 @@ struct PlanePrivate
 Plane::Plane(Viewport *viewport)
     : ViewportElement(viewport)
 {
-	p = new PlanePrivate();
+	p = new PlanePrivate(this);
 
 	onGeometryChange(scene->getGeometry());
 }
@@ -161,7 +219,8 @@ DEF_ATTR_RD_SIMPLE(Plane, ZoomX,     float,   p->zoomX)
 DEF_ATTR_RD_SIMPLE(Plane, ZoomY,     float,   p->zoomY)
 DEF_ATTR_RD_SIMPLE(Plane, BlendType, int,     p->blendType)
 
-DEF_ATTR_SIMPLE(Plane, Opacity,   int,     p->opacity)
+DEF_ATTR_RD_SIMPLE(Plane, Opacity,   int,     p->opacity)
+
 DEF_ATTR_SIMPLE(Plane, Color,     Color&, *p->color)
 DEF_ATTR_SIMPLE(Plane, Tone,      Tone&,  *p->tone)
 
@@ -175,6 +234,8 @@ void Plane::setBitmap(Bitmap *value)
 	guardDisposed();
 
 	p->bitmap = value;
+	p->updateBitmapCons();
+	notifyChange();
 
 	if (!value)
 		return;
@@ -192,6 +253,7 @@ void Plane::setOX(int value)
 
 	p->ox = value;
 	p->quadSourceDirty = true;
+	notifyChange();
 }
 
 void Plane::setOY(int value)
@@ -203,6 +265,7 @@ void Plane::setOY(int value)
 
 	p->oy = value;
 	p->quadSourceDirty = true;
+	notifyChange();
 }
 
 void Plane::setZoomX(float value)
@@ -214,6 +277,7 @@ void Plane::setZoomX(float value)
 
 	p->zoomX = value;
 	p->quadSourceDirty = true;
+	notifyChange();
 }
 
 void Plane::setZoomY(float value)
@@ -225,6 +289,7 @@ void Plane::setZoomY(float value)
 
 	p->zoomY = value;
 	p->quadSourceDirty = true;
+	notifyChange();
 }
 
 void Plane::setBlendType(int value)
@@ -236,20 +301,35 @@ void Plane::setBlendType(int value)
 	default :
 	case BlendNormal :
 		p->blendType = BlendNormal;
-		return;
+		break;
 	case BlendAddition :
 		p->blendType = BlendAddition;
-		return;
+		break;
 	case BlendSubstraction :
 		p->blendType = BlendSubstraction;
-		return;
+		break;
 	}
+
+	notifyChange();
+}
+
+void Plane::setOpacity(int value)
+{
+	guardDisposed();
+
+	if (p->opacity == value)
+		return;
+
+	p->opacity = value;
+	notifyChange();
 }
 
 void Plane::initDynAttribs()
 {
 	p->color = new Color;
 	p->tone = new Tone;
+
+	p->updateColorToneCons();
 }
 
 void Plane::draw()
@@ -264,7 +344,7 @@ void Plane::draw()
 
 	if (p->color->hasEffect() || p->tone->hasEffect() || p->opacity != 255)
 	{
-		PlaneShader &shader = shState->shaders().plane;
+		PlaneShader &shader = shState->shaders().plane();
 
 		shader.bind();
 		shader.applyViewportProj();
@@ -277,7 +357,7 @@ void Plane::draw()
 	}
 	else
 	{
-		SimpleShader &shader = shState->shaders().simple;
+		SimpleShader &shader = shState->shaders().simple();
 
 		shader.bind();
 		shader.applyViewportProj();
@@ -290,22 +370,40 @@ void Plane::draw()
 
 	p->bitmap->bindTex(*base);
 
-	if (gl.npot_repeat)
+	bool repeat = p->useRepeat();
+
+	if (repeat)
 		TEX::setRepeat(true);
 
 	p->qArray.draw();
 
-	if (gl.npot_repeat)
+	if (repeat)
 		TEX::setRepeat(false);
 
 	glState.blendMode.pop();
 }
 
-void Plane::onGeometryChange(const Scene::Geometry &geo)
+bool Plane::getCullBounds(IntRect &bounds, bool &opaque) const
 {
-	if (gl.npot_repeat)
-		Quad::setPosRect(&p->qArray.vertices[0], FloatRect(geo.rect));
+	/* Planes always tile their entire scene */
+	bounds = IntRect(Vec2i(), p->sceneGeo.rect.size());
+
+	opaque = !nullOrDisposed(p->bitmap)   &&
+	         p->bitmap->isOpaque()        &&
+	         p->opacity == 255            &&
+	         p->blendType == BlendNormal  &&
+	         p->zoomX > 0 && p->zoomY > 0;
+
+	return true;
+}
 
+bool Plane::blendsNormally() const
+{
+	return p->blendType == BlendNormal;
+}
+
+void Plane::onGeometryChange(const Scene::Geometry &geo)
+{
 	p->sceneGeo = geo;
 	p->quadSourceDirty = true;
 }
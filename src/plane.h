@@ -54,6 +54,8 @@ private:
 
 	void draw();
 	void onGeometryChange(const Scene::Geometry &);
+	bool getCullBounds(IntRect &bounds, bool &opaque) const;
+	bool blendsNormally() const;
 
 	void releaseResources();
 	const char *klassName() const { return "plane"; }
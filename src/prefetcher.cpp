@@ -0,0 +1,595 @@
+/*
+** prefetcher.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "prefetcher.h"
+
+#include "config.h"
+#include "boost-hash.h"
+#include "debugwriter.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifdef __EMSCRIPTEN__
+#include "emscripten.hpp"
+#else
+#include "sdl-util.h"
+
+#include <SDL_mutex.h>
+#include <SDL_timer.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+/* Same as getMappingKey() in drive.js: lower case,
+ * last extension stripped */
+static std::string assetKey(const std::string &path)
+{
+	std::string key(path);
+
+	for (size_t i = 0; i < key.size(); ++i)
+		key[i] = tolower((unsigned char) key[i]);
+
+	size_t dot = key.rfind('.');
+	size_t slash = key.rfind('/');
+
+	if (dot != std::string::npos && (slash == std::string::npos || dot > slash))
+		key.erase(dot);
+
+	return key;
+}
+
+static bool isMapKey(const std::string &key)
+{
+	const std::string name = key.substr(key.rfind('/') + 1);
+
+	if (name.size() <= 3 || name.compare(0, 3, "map") != 0)
+		return false;
+
+	return name.find_first_not_of("0123456789", 3) == std::string::npos;
+}
+
+#ifdef __EMSCRIPTEN__
+static void splitLines(const std::string &list, std::vector<std::string> &out)
+{
+	size_t start = 0;
+
+	while (start < list.size())
+	{
+		size_t end = list.find('\n', start);
+
+		if (end == std::string::npos)
+			end = list.size();
+
+		if (end > start)
+			out.push_back(list.substr(start, end - start));
+
+		start = end + 1;
+	}
+}
+#else
+/* The JSON array of paths mkxp-preload writes */
+static void splitJSON(const std::string &json, std::vector<std::string> &out)
+{
+	size_t start = json.find('"');
+
+	while (start != std::string::npos)
+	{
+		size_t end = json.find('"', start + 1);
+
+		if (end == std::string::npos)
+			break;
+
+		out.push_back(json.substr(start + 1, end - start - 1));
+		start = json.find('"', end + 1);
+	}
+}
+#endif
+
+struct PrefetcherPrivate
+{
+	bool enabled;
+	size_t concurrency;
+	size_t budget;
+
+	/* Paths to fetch, most likely needed first */
+	std::deque<std::string> queue;
+
+	/* Keys queued this round */
+	std::set<std::string> queued;
+
+	/* Keys demanded so far; only the first demand counts */
+	std::set<std::string> demanded;
+
+	Prefetcher::Stats stats;
+
+#ifdef __EMSCRIPTEN__
+	/* Map files whose manifest is being fetched */
+	std::vector<std::pair<std::string, bool> > manifests;
+
+	std::vector<std::string> inFlight;
+
+	/* Fetched files stay in the FS like ones loaded on
+	 * demand, so the budget limits what each round fetches */
+	size_t roundFetched;
+#else
+	std::string sourceDir;
+	int latency;
+
+	/* Maps: asset key,
+	 * to:   path relative to sourceDir */
+	BoostHash<std::string, std::string> sourceIndex;
+
+	/* Everything below is shared with the workers */
+	SDL_mutex *mutex;
+	SDL_cond *cond;
+	std::vector<SDL_Thread*> workers;
+	bool quit;
+
+	std::deque<std::string> jobs;
+	std::set<std::string> inFlight;
+
+	/* In flight keys a newer round doesn't predict;
+	 * their contents are thrown away on arrival */
+	std::set<std::string> discard;
+
+	/* Maps: asset key,
+	 * to:   fetched contents, until demanded or no
+	 *       longer predicted. Bounded by the budget */
+	BoostHash<std::string, std::string> cache;
+	size_t cachedBytes;
+#endif
+
+	PrefetcherPrivate(const Config &conf)
+	    : enabled(conf.prefetch.enabled),
+	      concurrency(conf.prefetch.concurrency),
+	      budget((size_t) conf.prefetch.budget * 1000000)
+	{
+		memset(&stats, 0, sizeof(stats));
+
+#ifdef __EMSCRIPTEN__
+		roundFetched = 0;
+#else
+		sourceDir = conf.prefetch.source;
+		latency = conf.prefetch.latency;
+		mutex = SDL_CreateMutex();
+		cond = SDL_CreateCond();
+		quit = false;
+		cachedBytes = 0;
+
+		/* Without a source there is nothing to fetch from */
+		if (sourceDir.empty())
+			enabled = false;
+
+		if (!enabled)
+			return;
+
+		indexSource("");
+
+		for (size_t i = 0; i < concurrency; ++i)
+			workers.push_back(createSDLThread
+				<PrefetcherPrivate, &PrefetcherPrivate::workerFun>(this, "prefetch"));
+
+		Debug() << "Prefetching from" << sourceDir << "with"
+		        << latency << "ms latency";
+#endif
+	}
+
+	~PrefetcherPrivate()
+	{
+#ifndef __EMSCRIPTEN__
+		SDL_LockMutex(mutex);
+		quit = true;
+		SDL_CondBroadcast(cond);
+		SDL_UnlockMutex(mutex);
+
+		for (size_t i = 0; i < workers.size(); ++i)
+			SDL_WaitThread(workers[i], 0);
+
+		SDL_DestroyCond(cond);
+		SDL_DestroyMutex(mutex);
+#endif
+	}
+
+	void newRound()
+	{
+		queue.clear();
+		queued.clear();
+
+#ifdef __EMSCRIPTEN__
+		manifests.clear();
+		roundFetched = 0;
+#endif
+	}
+
+	void enqueue(const std::string &path)
+	{
+		const std::string key = assetKey(path);
+
+		if (!queued.insert(key).second || demanded.count(key))
+			return;
+
+		queue.push_back(path);
+	}
+
+	/* Assets of the loaded map (primary) come first, then the
+	 * maps it can transfer to, then those maps' assets */
+	void manifestLoaded(const std::vector<std::string> &paths, bool primary)
+	{
+		std::vector<std::string> maps;
+
+		for (size_t i = 0; i < paths.size(); ++i)
+		{
+			if (isMapKey(assetKey(paths[i])))
+				maps.push_back(paths[i]);
+			else
+				enqueue(paths[i]);
+		}
+
+		if (!primary)
+			return;
+
+		for (size_t i = 0; i < maps.size(); ++i)
+		{
+			enqueue(maps[i]);
+			requestManifest(maps[i], false);
+		}
+	}
+
+#ifdef __EMSCRIPTEN__
+	void requestManifest(const std::string &mapFile, bool primary)
+	{
+		prefetch_manifest_js(mapFile.c_str());
+		manifests.push_back(std::make_pair(mapFile, primary));
+	}
+
+	bool isAvailable(const std::string &path)
+	{
+		return file_is_cached(path.c_str()) || file_is_pending(path.c_str());
+	}
+
+	void update()
+	{
+		for (size_t i = 0; i < manifests.size();)
+		{
+			char *list = prefetch_take_manifest_js(manifests[i].first.c_str());
+
+			if (!list)
+			{
+				++i;
+				continue;
+			}
+
+			const bool primary = manifests[i].second;
+			manifests.erase(manifests.begin() + i);
+
+			std::vector<std::string> paths;
+			splitLines(list, paths);
+			free(list);
+
+			manifestLoaded(paths, primary);
+		}
+
+		for (size_t i = 0; i < inFlight.size();)
+		{
+			int size = prefetch_status_js(inFlight[i].c_str());
+
+			if (size < 0)
+			{
+				++i;
+				continue;
+			}
+
+			roundFetched += size;
+			inFlight.erase(inFlight.begin() + i);
+		}
+
+		stats.bytes = roundFetched;
+
+		while (inFlight.size() < concurrency && !queue.empty())
+		{
+			if (roundFetched >= budget)
+			{
+				stats.dropped += queue.size();
+				queue.clear();
+				break;
+			}
+
+			const std::string path = queue.front();
+			queue.pop_front();
+
+			if (isAvailable(path))
+				continue;
+
+			prefetch_file_js(path.c_str());
+			inFlight.push_back(path);
+			++stats.issued;
+		}
+	}
+
+	void demand(const std::string &filename)
+	{
+		if (!demanded.insert(assetKey(filename)).second)
+			return;
+
+		if (isAvailable(filename))
+			++stats.hits;
+		else
+			++stats.misses;
+	}
+#else
+	void indexSource(const std::string &dir)
+	{
+		const std::string fullDir = sourceDir + "/" + dir;
+		DIR *d = opendir(fullDir.c_str());
+
+		if (!d)
+			return;
+
+		while (dirent *e = readdir(d))
+		{
+			if (e->d_name[0] == '.')
+				continue;
+
+			const std::string path = dir.empty() ? e->d_name : dir + "/" + e->d_name;
+			const std::string fullPath = sourceDir + "/" + path;
+
+			struct stat st;
+
+			if (stat(fullPath.c_str(), &st) != 0)
+				continue;
+
+			if (S_ISDIR(st.st_mode))
+				indexSource(path);
+			else
+				sourceIndex.insert(assetKey(path), path);
+		}
+
+		closedir(d);
+	}
+
+	/* Stands in for a network request */
+	bool fetch(const std::string &key, std::string &data)
+	{
+		SDL_Delay(latency);
+
+		if (!sourceIndex.contains(key))
+			return false;
+
+		return readFileSDL((sourceDir + "/" + sourceIndex[key]).c_str(), data);
+	}
+
+	void workerFun()
+	{
+		SDL_LockMutex(mutex);
+
+		while (!quit)
+		{
+			if (jobs.empty())
+			{
+				SDL_CondWait(cond, mutex);
+				continue;
+			}
+
+			const std::string key = jobs.front();
+			jobs.pop_front();
+			inFlight.insert(key);
+
+			SDL_UnlockMutex(mutex);
+
+			std::string data;
+			bool ok = fetch(key, data);
+
+			SDL_LockMutex(mutex);
+
+			inFlight.erase(key);
+
+			if (discard.erase(key))
+				ok = false;
+
+			if (ok)
+			{
+				cachedBytes += data.size();
+				cache[key].swap(data);
+			}
+
+			SDL_CondBroadcast(cond);
+		}
+
+		SDL_UnlockMutex(mutex);
+	}
+
+	/* Called once the new round's queue is complete (manifests
+	 * are read synchronously here). Drops whatever the previous
+	 * rounds fetched, or were about to, that it no longer
+	 * predicts, so the cache only ever holds one round's worth */
+	void evictStale()
+	{
+		SDL_LockMutex(mutex);
+
+		std::vector<std::string> stale;
+
+		for (BoostHash<std::string, std::string>::const_iterator iter = cache.cbegin();
+		     iter != cache.cend(); ++iter)
+			if (!queued.count(iter->first))
+				stale.push_back(iter->first);
+
+		for (size_t i = 0; i < stale.size(); ++i)
+		{
+			cachedBytes -= cache[stale[i]].size();
+			cache.remove(stale[i]);
+		}
+
+		/* Still wanted ones get issued again from the new queue */
+		jobs.clear();
+
+		discard.clear();
+
+		for (std::set<std::string>::const_iterator iter = inFlight.begin();
+		     iter != inFlight.end(); ++iter)
+			if (!queued.count(*iter))
+				discard.insert(*iter);
+
+		SDL_UnlockMutex(mutex);
+	}
+
+	void requestManifest(const std::string &mapFile, bool primary)
+	{
+		std::string json;
+
+		if (!readFileSDL((sourceDir + "/preload/" + mapFile + ".json").c_str(), json))
+			return;
+
+		std::vector<std::string> paths;
+		splitJSON(json, paths);
+
+		manifestLoaded(paths, primary);
+	}
+
+	void update()
+	{
+		SDL_LockMutex(mutex);
+
+		while (jobs.size() + inFlight.size() < concurrency && !queue.empty())
+		{
+			if (cachedBytes >= budget)
+			{
+				stats.dropped += queue.size();
+				queue.clear();
+				break;
+			}
+
+			const std::string key = assetKey(queue.front());
+			queue.pop_front();
+
+			if (cache.contains(key) || inFlight.count(key))
+				continue;
+
+			jobs.push_back(key);
+			++stats.issued;
+		}
+
+		SDL_CondBroadcast(cond);
+
+		stats.bytes = cachedBytes;
+
+		SDL_UnlockMutex(mutex);
+	}
+
+	void demand(const std::string &filename)
+	{
+		const std::string key = assetKey(filename);
+
+		if (!demanded.insert(key).second)
+			return;
+
+		SDL_LockMutex(mutex);
+
+		/* Not picked up by a worker yet; take it back */
+		for (size_t i = 0; i < jobs.size(); ++i)
+			if (jobs[i] == key)
+			{
+				jobs.erase(jobs.begin() + i);
+				break;
+			}
+
+		while (inFlight.count(key))
+			SDL_CondWait(cond, mutex);
+
+		const bool hit = cache.contains(key);
+
+		if (hit)
+		{
+			/* Handed over to the loader */
+			cachedBytes -= cache[key].size();
+			cache.remove(key);
+		}
+
+		SDL_UnlockMutex(mutex);
+
+		if (hit)
+		{
+			++stats.hits;
+		}
+		else
+		{
+			/* Pay for the synchronous request */
+			std::string data;
+			fetch(key, data);
+
+			++stats.misses;
+		}
+	}
+#endif
+};
+
+Prefetcher::Prefetcher(const Config &conf)
+{
+	p = new PrefetcherPrivate(conf);
+}
+
+Prefetcher::~Prefetcher()
+{
+	delete p;
+}
+
+void Prefetcher::dataLoaded(const char *filename)
+{
+	if (!p->enabled || !isMapKey(assetKey(filename)))
+		return;
+
+	p->newRound();
+	p->requestManifest(filename, true);
+
+#ifndef __EMSCRIPTEN__
+	p->evictStale();
+#endif
+}
+
+void Prefetcher::demand(const char *filename)
+{
+	if (!p->enabled)
+		return;
+
+	p->demand(filename);
+}
+
+void Prefetcher::update()
+{
+	if (!p->enabled)
+		return;
+
+	p->update();
+}
+
+Prefetcher::Stats Prefetcher::takeStats()
+{
+	Stats result = p->stats;
+
+	p->stats.hits = p->stats.misses = 0;
+	p->stats.issued = p->stats.dropped = 0;
+
+	return result;
+}
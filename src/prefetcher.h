@@ -0,0 +1,77 @@
+/*
+** prefetcher.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <stddef.h>
+
+struct Config;
+struct PrefetcherPrivate;
+
+/* Fetches the assets a map depends on (and those of the maps
+ * it can transfer to) in the background, going by the preload
+ * manifests written by mkxp-preload.
+ *
+ * On the web, assets end up in the Emscripten FS just like
+ * ones loaded on demand. Natively there is nothing to fetch,
+ * so 'prefetch.source' names a directory standing in for the
+ * server, read with 'prefetch.latency' ms per file */
+class Prefetcher
+{
+public:
+	struct Stats
+	{
+		/* Demanded assets that were already fetched
+		 * (or in flight) versus ones that weren't */
+		unsigned int hits;
+		unsigned int misses;
+
+		/* Prefetches started, and ones skipped
+		 * because the memory budget ran out */
+		unsigned int issued;
+		unsigned int dropped;
+
+		/* Natively, held by prefetched assets not demanded
+		 * yet (all predicted by the current round). On the
+		 * web, fetched ahead during the current round */
+		size_t bytes;
+	};
+
+	Prefetcher(const Config &conf);
+	~Prefetcher();
+
+	/* Called with every file passed to load_data; map
+	 * files start a new round of predictions */
+	void dataLoaded(const char *filename);
+
+	/* Called before an asset is loaded synchronously */
+	void demand(const char *filename);
+
+	/* Issues queued fetches within the concurrency and
+	 * memory limits; called once per frame */
+	void update();
+
+	Stats takeStats();
+
+private:
+	PrefetcherPrivate *p;
+};
+
+#endif // PREFETCHER_H
@@ -0,0 +1,307 @@
+/*
+** programcache.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "programcache.h"
+
+#include "config.h"
+#include "boost-hash.h"
+#include "debugwriter.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+/* Header, driver tag, then per program: u32 name length, name,
+ * u32 source CRC, u32 binary format, u32 data size, data */
+#define FORMAT_VER 1
+
+/* Sanity limits for damaged files */
+#define MAX_TAG_LEN  1024
+#define MAX_NAME_LEN 256
+#define MAX_COUNT    256
+#define MAX_DATA     0x1000000
+
+/* Other caches have their own Header and Entry */
+namespace
+{
+
+struct Header
+{
+	char magic[8];
+	uint32_t formVer;
+	uint32_t tagLen;
+	uint32_t count;
+};
+
+struct Entry
+{
+	uint32_t srcCrc;
+	uint32_t format;
+	std::string data;
+};
+
+}
+
+typedef BoostHash<std::string, Entry> EntryHash;
+
+#define READ(ptr, size, n, f) if (fread(ptr, size, n, f) < n) return false
+
+static bool readString(FILE *f, std::string &out, uint32_t maxLen)
+{
+	uint32_t len;
+	READ(&len, sizeof(uint32_t), 1, f);
+
+	if (len > maxLen)
+		return false;
+
+	out.resize(len);
+
+	if (len > 0)
+		READ(&out[0], 1, len, f);
+
+	return true;
+}
+
+static bool readCache(FILE *f, const std::string &tag, EntryHash &out)
+{
+	Header hd;
+	READ(&hd, sizeof(hd), 1, f);
+
+	if (memcmp(hd.magic, "MKXPPRGC", 8) != 0 || hd.formVer != FORMAT_VER)
+		return false;
+
+	if (hd.tagLen != tag.size() || hd.tagLen > MAX_TAG_LEN || hd.count > MAX_COUNT)
+		return false;
+
+	std::string fileTag(hd.tagLen, '\0');
+
+	if (hd.tagLen > 0)
+		READ(&fileTag[0], 1, hd.tagLen, f);
+
+	if (fileTag != tag)
+		return false;
+
+	for (size_t i = 0; i < hd.count; ++i)
+	{
+		std::string name;
+		Entry e;
+
+		if (!readString(f, name, MAX_NAME_LEN))
+			return false;
+
+		READ(&e.srcCrc, sizeof(uint32_t), 1, f);
+		READ(&e.format, sizeof(uint32_t), 1, f);
+
+		if (!readString(f, e.data, MAX_DATA))
+			return false;
+
+		out.insert(name, e);
+	}
+
+	return true;
+}
+
+#undef READ
+
+static std::string glString(GLenum name)
+{
+	const char *str = (const char*) gl.GetString(name);
+
+	return str ? str : "";
+}
+
+struct ProgramCachePrivate
+{
+	std::string path;
+	std::string tag;
+	EntryHash entries;
+	bool dirty;
+
+	ProgramCachePrivate(const Config &conf)
+	    : dirty(false)
+	{
+#ifndef __EMSCRIPTEN__
+		/* WebGL has no program binaries */
+		if (!gl.GetProgramBinary)
+			return;
+
+		/* Binaries don't depend on the game */
+		const std::string &dir = conf.commonDataPath.empty()
+		        ? conf.customDataPath : conf.commonDataPath;
+
+		if (dir.empty())
+			return;
+
+		path = dir + "shaders.mkxpc";
+		tag = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+
+		load();
+#else
+		(void) conf;
+#endif
+	}
+
+	void load()
+	{
+		FILE *f = fopen(path.c_str(), "rb");
+
+		if (!f)
+			return;
+
+		if (!readCache(f, tag, entries))
+			entries = EntryHash();
+
+		fclose(f);
+	}
+
+	void write()
+	{
+		/* Written aside and moved into place, so an interrupted
+		 * write can't leave a truncated cache behind */
+		const std::string tmpPath = path + ".tmp";
+		FILE *f = fopen(tmpPath.c_str(), "wb");
+
+		if (!f)
+			return;
+
+		Header hd;
+		memcpy(hd.magic, "MKXPPRGC", 8);
+		hd.formVer = FORMAT_VER;
+		hd.tagLen = tag.size();
+		hd.count = 0;
+
+		for (EntryHash::const_iterator iter = entries.cbegin();
+		     iter != entries.cend(); ++iter)
+			++hd.count;
+
+		bool ok = fwrite(&hd, sizeof(hd), 1, f) == 1 &&
+		          fwrite(tag.data(), 1, tag.size(), f) == tag.size();
+
+		for (EntryHash::const_iterator iter = entries.cbegin();
+		     ok && iter != entries.cend(); ++iter)
+		{
+			const std::string &name = iter->first;
+			const Entry &e = iter->second;
+			const uint32_t nameLen = name.size();
+			const uint32_t size = e.data.size();
+
+			ok = fwrite(&nameLen, sizeof(uint32_t), 1, f) == 1 &&
+			     fwrite(name.data(), 1, nameLen, f) == nameLen &&
+			     fwrite(&e.srcCrc, sizeof(uint32_t), 1, f) == 1 &&
+			     fwrite(&e.format, sizeof(uint32_t), 1, f) == 1 &&
+			     fwrite(&size, sizeof(uint32_t), 1, f) == 1 &&
+			     fwrite(e.data.data(), 1, size, f) == size;
+		}
+
+		if (fclose(f) != 0)
+			ok = false;
+
+#ifdef _WIN32
+		/* rename() doesn't replace existing files here */
+		if (ok)
+			remove(path.c_str());
+#endif
+
+		if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+		{
+			remove(tmpPath.c_str());
+			return;
+		}
+
+		Debug() << "Wrote shader program cache" << path;
+	}
+};
+
+ProgramCache::ProgramCache(const Config &conf)
+{
+	p = new ProgramCachePrivate(conf);
+}
+
+ProgramCache::~ProgramCache()
+{
+	delete p;
+}
+
+bool ProgramCache::load(GLuint program, const char *name, uint32_t srcCrc)
+{
+	if (p->path.empty())
+		return false;
+
+	if (!p->entries.contains(name))
+		return false;
+
+	const Entry &e = p->entries[name];
+
+	if (e.srcCrc == srcCrc)
+	{
+		gl.ProgramBinary(program, e.format, e.data.data(), e.data.size());
+
+		GLint success;
+		gl.GetProgramiv(program, GL_LINK_STATUS, &success);
+
+		if (success)
+			return true;
+	}
+
+	/* Stale, or rejected after a driver update
+	 * that kept the version string */
+	p->entries.remove(name);
+	p->dirty = true;
+
+	return false;
+}
+
+void ProgramCache::store(GLuint program, const char *name, uint32_t srcCrc)
+{
+	if (p->path.empty())
+		return;
+
+	GLint size = 0;
+	gl.GetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &size);
+
+	if (size <= 0 || size > MAX_DATA)
+		return;
+
+	Entry e;
+	e.srcCrc = srcCrc;
+	e.data.resize(size);
+
+	GLsizei written = 0;
+	GLenum format = 0;
+	gl.GetProgramBinary(program, size, &written, &format, &e.data[0]);
+
+	if (written <= 0)
+		return;
+
+	e.data.resize(written);
+	e.format = format;
+
+	p->entries[name] = e;
+	p->dirty = true;
+}
+
+void ProgramCache::flush()
+{
+	if (!p->dirty || p->path.empty())
+		return;
+
+	p->write();
+	p->dirty = false;
+}
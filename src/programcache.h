@@ -0,0 +1,57 @@
+/*
+** programcache.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef PROGRAMCACHE_H
+#define PROGRAMCACHE_H
+
+#include "gl-fun.h"
+
+#include <stdint.h>
+
+struct Config;
+struct ProgramCachePrivate;
+
+/* On-disk cache of linked shader program binaries, shared by
+ * all games in the common data path. Only usable where the
+ * driver supports program binaries at all.
+ *
+ * Entries are matched by program name and the CRC of its full
+ * source. The cache as a whole belongs to one driver (vendor,
+ * renderer and version string) and is discarded on any change */
+class ProgramCache
+{
+public:
+	ProgramCache(const Config &conf);
+	~ProgramCache();
+
+	/* Links 'program' from a cached binary; false if
+	 * there is none, or the driver rejected it */
+	bool load(GLuint program, const char *name, uint32_t srcCrc);
+
+	/* Takes the binary of freshly linked 'program' */
+	void store(GLuint program, const char *name, uint32_t srcCrc);
+
+	/* Writes the cache back if anything changed */
+	void flush();
+
+private:
+	ProgramCachePrivate *p;
+};
+
+#endif // PROGRAMCACHE_H
@@ -0,0 +1,282 @@
+/*
+** savewriter.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "savewriter.h"
+
+#include "debugwriter.h"
+#include "exception.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <deque>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <unistd.h>
+#endif
+
+#ifndef __EMSCRIPTEN__
+#include "sdl-util.h"
+
+#include <SDL_mutex.h>
+#endif
+
+struct Job
+{
+	std::string path;
+	std::string data;
+};
+
+/* Paths are UTF-8, as everywhere else in mkxp; the narrow
+ * file APIs on Windows would take them as ANSI instead */
+#ifdef _WIN32
+static std::wstring widen(const std::string &str)
+{
+	const int len = MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, 0, 0);
+
+	if (len <= 0)
+		return std::wstring();
+
+	std::wstring result(len, L'\0');
+	MultiByteToWideChar(CP_UTF8, 0, str.c_str(), -1, &result[0], len);
+	result.resize(len - 1);
+
+	return result;
+}
+#endif
+
+static FILE *openForWriting(const std::string &path)
+{
+#ifdef _WIN32
+	return _wfopen(widen(path).c_str(), L"wb");
+#else
+	return fopen(path.c_str(), "wb");
+#endif
+}
+
+static void removeFile(const std::string &path)
+{
+#ifdef _WIN32
+	_wremove(widen(path).c_str());
+#else
+	remove(path.c_str());
+#endif
+}
+
+static bool replaceFile(const std::string &from, const std::string &to)
+{
+#ifdef _WIN32
+	/* rename() doesn't replace existing files here */
+	return MoveFileExW(widen(from).c_str(), widen(to).c_str(),
+	                   MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+#else
+	return rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+/* Returns an empty string on success, the error otherwise */
+static std::string writeAtomic(const std::string &path, const std::string &data)
+{
+	const std::string tmpPath = path + ".tmp";
+	FILE *f = openForWriting(tmpPath);
+
+	if (!f)
+		return std::string(strerror(errno));
+
+	bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+	ok = ok && fflush(f) == 0;
+
+	/* Make sure the data hits the disk before the rename
+	 * does, or a power loss could leave an empty file */
+#ifdef _WIN32
+	ok = ok && _commit(_fileno(f)) == 0;
+#elif !defined(__EMSCRIPTEN__)
+	ok = ok && fsync(fileno(f)) == 0;
+#endif
+
+	const int err = errno;
+
+	if (fclose(f) != 0)
+		ok = false;
+
+	if (!ok)
+	{
+		removeFile(tmpPath);
+		return std::string(strerror(err));
+	}
+
+	if (!replaceFile(tmpPath, path))
+	{
+		removeFile(tmpPath);
+		return "cannot replace file";
+	}
+
+	return std::string();
+}
+
+struct SaveWriterPrivate
+{
+	/* First failure not yet reported to the game */
+	std::string error;
+
+#ifndef __EMSCRIPTEN__
+	/* Everything below is shared with the worker */
+	SDL_mutex *mutex;
+	SDL_cond *cond;
+	SDL_Thread *worker;
+	bool quit;
+
+	std::deque<Job> jobs;
+	bool busy;
+
+	SaveWriterPrivate()
+	    : quit(false),
+	      busy(false)
+	{
+		mutex = SDL_CreateMutex();
+		cond = SDL_CreateCond();
+
+		worker = createSDLThread
+			<SaveWriterPrivate, &SaveWriterPrivate::workerFun>(this, "savewriter");
+	}
+
+	~SaveWriterPrivate()
+	{
+		/* The worker drains the queue before quitting */
+		SDL_LockMutex(mutex);
+		quit = true;
+		SDL_CondBroadcast(cond);
+		SDL_UnlockMutex(mutex);
+
+		SDL_WaitThread(worker, 0);
+
+		SDL_DestroyCond(cond);
+		SDL_DestroyMutex(mutex);
+	}
+
+	void workerFun()
+	{
+		SDL_LockMutex(mutex);
+
+		while (true)
+		{
+			if (jobs.empty())
+			{
+				if (quit)
+					break;
+
+				SDL_CondWait(cond, mutex);
+				continue;
+			}
+
+			Job job;
+			job.path.swap(jobs.front().path);
+			job.data.swap(jobs.front().data);
+			jobs.pop_front();
+			busy = true;
+
+			SDL_UnlockMutex(mutex);
+
+			const std::string result = writeAtomic(job.path, job.data);
+
+			if (!result.empty())
+				Debug() << "Failed to write" << job.path << ":" << result;
+
+			SDL_LockMutex(mutex);
+
+			if (!result.empty() && error.empty())
+				error = job.path + ": " + result;
+
+			busy = false;
+			SDL_CondBroadcast(cond);
+		}
+
+		SDL_UnlockMutex(mutex);
+	}
+#endif
+};
+
+SaveWriter::SaveWriter()
+{
+	p = new SaveWriterPrivate;
+}
+
+SaveWriter::~SaveWriter()
+{
+	delete p;
+}
+
+void SaveWriter::write(const std::string &path, std::string &data)
+{
+#ifdef __EMSCRIPTEN__
+	/* No threads here; the file only lives in memory
+	 * until it's synced anyway */
+	const std::string result = writeAtomic(path, data);
+
+	if (!result.empty())
+		throw Exception(Exception::IOError, "%s: %s", path.c_str(), result.c_str());
+#else
+	SDL_LockMutex(p->mutex);
+
+	/* An earlier write failed; report that instead of taking
+	 * new data, so a raised save_data never writes anything */
+	if (!p->error.empty())
+	{
+		std::string error;
+		error.swap(p->error);
+
+		SDL_UnlockMutex(p->mutex);
+
+		throw Exception(Exception::IOError, "%s", error.c_str());
+	}
+
+	Job *pending = 0;
+
+	for (size_t i = 0; i < p->jobs.size(); ++i)
+		if (p->jobs[i].path == path)
+			pending = &p->jobs[i];
+
+	if (!pending)
+	{
+		p->jobs.push_back(Job());
+		pending = &p->jobs.back();
+		pending->path = path;
+	}
+
+	pending->data.swap(data);
+
+	SDL_CondBroadcast(p->cond);
+	SDL_UnlockMutex(p->mutex);
+#endif
+}
+
+void SaveWriter::flush()
+{
+#ifndef __EMSCRIPTEN__
+	SDL_LockMutex(p->mutex);
+
+	while (!p->jobs.empty() || p->busy)
+		SDL_CondWait(p->cond, p->mutex);
+
+	SDL_UnlockMutex(p->mutex);
+#endif
+}
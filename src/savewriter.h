@@ -0,0 +1,51 @@
+/*
+** savewriter.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SAVEWRITER_H
+#define SAVEWRITER_H
+
+#include <string>
+
+struct SaveWriterPrivate;
+
+/* Writes save_data output on a background thread, so the RGSS
+ * thread only pays for marshalling. Every file is written aside,
+ * synced and then renamed over the old one, so a crash mid-write
+ * leaves the previous save intact.
+ *
+ * Writes happen in call order; writing a path that still has a
+ * write queued just replaces the data of that one */
+class SaveWriter
+{
+public:
+	SaveWriter();
+	~SaveWriter();
+
+	/* Takes over 'data'. If an earlier background write
+	 * failed, throws that error and leaves 'data' alone */
+	void write(const std::string &path, std::string &data);
+
+	/* Blocks until everything queued is on disk */
+	void flush();
+
+private:
+	SaveWriterPrivate *p;
+};
+
+#endif // SAVEWRITER_H
@@ -22,6 +22,10 @@
 #include "scene.h"
 #include "sharedstate.h"
 
+#include <SDL_rect.h>
+
+static Scene::CullStats cullStats;
+
 Scene::Scene()
 {}
 
@@ -40,6 +44,8 @@ void Scene::insert(SceneElement &element)
 {
 	IntruListLink<SceneElement> *iter;
 
+	onElementsChanged();
+
 	for (iter = elements.begin(); iter != elements.end(); iter = iter->next)
 	{
 		SceneElement *e = iter->data;
@@ -58,6 +64,8 @@ void Scene::insertAfter(SceneElement &element, SceneElement &after)
 {
 	IntruListLink<SceneElement> *iter;
 
+	onElementsChanged();
+
 	for (iter = &after.link; iter != elements.end(); iter = iter->next)
 	{
 		SceneElement *e = iter->data;
@@ -90,15 +98,56 @@ void Scene::notifyGeometryChange()
 
 void Scene::composite()
 {
+	const IntRect clip(Vec2i(), geometry.rect.size());
 	IntruListLink<SceneElement> *iter;
+	IntruListLink<SceneElement> *first = elements.begin();
 
-	for (iter = elements.begin(); iter != elements.end(); iter = iter->next)
+	IntRect bounds;
+	bool opaque;
+
+	/* Nothing below the topmost element that opaquely
+	 * covers the whole scene can show through */
+	for (iter = elements.end()->prev; iter != elements.end(); iter = iter->prev)
 	{
 		SceneElement *e = iter->data;
 
-		if (e->visible)
-			e->draw();
+		if (!e->visible || !e->getCullBounds(bounds, opaque))
+			continue;
+
+		if (opaque && bounds.encloses(clip))
+		{
+			first = iter;
+			break;
+		}
 	}
+
+	for (iter = elements.begin(); iter != first; iter = iter->next)
+		if (iter->data->visible)
+			++cullStats.occluded;
+
+	for (iter = first; iter != elements.end(); iter = iter->next)
+	{
+		SceneElement *e = iter->data;
+
+		if (!e->visible)
+			continue;
+
+		if (e->getCullBounds(bounds, opaque) && !SDL_HasIntersection(&bounds, &clip))
+		{
+			++cullStats.offScreen;
+			continue;
+		}
+
+		e->draw();
+	}
+}
+
+Scene::CullStats Scene::takeCullStats()
+{
+	CullStats stats = cullStats;
+	cullStats.offScreen = cullStats.occluded = 0;
+
+	return stats;
 }
 
 
@@ -147,6 +196,12 @@ void SceneElement::setZ(int value)
 	scene->reinsert(*this);
 }
 
+void SceneElement::notifyChange()
+{
+	if (scene)
+		scene->onElementsChanged();
+}
+
 bool SceneElement::getVisible() const
 {
 	aboutToAccess();
@@ -158,6 +213,9 @@ void SceneElement::setVisible(bool value)
 {
 	aboutToAccess();
 
+	if (visible != value && scene)
+		scene->onElementsChanged();
+
 	visible = value;
 }
 
@@ -197,6 +255,9 @@ void SceneElement::setSpriteY(int value)
 
 void SceneElement::unlink()
 {
-	if (scene)
-		scene->elements.remove(link);
+	if (!scene)
+		return;
+
+	scene->elements.remove(link);
+	scene->onElementsChanged();
 }
@@ -59,6 +59,19 @@ public:
 	                                   const Vec4& /* flash */,
 	                                   const Vec4& /* tone */) {}
 
+	/* Elements skipped by composite() since the last call */
+	struct CullStats
+	{
+		unsigned int offScreen;
+		unsigned int occluded;
+	};
+
+	static CullStats takeCullStats();
+
+	/* Binds the framebuffer this scene composites into again,
+	 * for elements that had to render elsewhere mid draw */
+	virtual void bindRenderTarget() {}
+
 	const Geometry &getGeometry() const { return geometry; }
 
 protected:
@@ -66,6 +79,11 @@ protected:
 	void insertAfter(SceneElement &element, SceneElement &after);
 	void reinsert(SceneElement &element);
 
+	/* Called when elements are added, removed, reordered,
+	 * change their visibility or report any other change
+	 * in what they draw */
+	virtual void onElementsChanged() {}
+
 	/* Notify all elements that geometry has changed */
 	void notifyGeometryChange();
 
@@ -91,6 +109,22 @@ public:
 
 	virtual void aboutToAccess() const = 0;
 
+	/* Culling information: the area this element may draw to,
+	 * relative to its scene's top left corner, and whether it
+	 * covers all of that area with fully opaque pixels.
+	 * Elements that can't tell return false and are always drawn */
+	virtual bool getCullBounds(IntRect & /* bounds */,
+	                           bool & /* opaque */) const { return false; }
+
+	/* Whether this element draws with BlendNormal only; others
+	 * depend on what is already drawn below them */
+	virtual bool blendsNormally() const { return true; }
+
+	/* Tells the scene that this element will draw differently
+	 * than before, for scenes that keep what they composited
+	 * (cached viewports). Also usable as a signal slot */
+	void notifyChange();
+
 protected:
 	/* A bit about OpenGL state:
 	 *
@@ -0,0 +1,252 @@
+/*
+** scriptcache.cpp
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "scriptcache.h"
+
+#include "config.h"
+#include "debugwriter.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <zlib.h>
+
+#include <vector>
+
+/* Header, tag, then per script: u32 checksum, u32 source CRC,
+ * u32 data size, data */
+#define FORMAT_VER 2
+
+/* Sanity limits for damaged files */
+#define MAX_TAG_LEN 256
+#define MAX_COUNT   0x10000
+#define MAX_DATA    0x1000000
+
+/* Other caches have their own Header and Entry */
+namespace
+{
+
+struct Header
+{
+	char magic[8];
+	uint32_t formVer;
+	uint32_t tagLen;
+	uint32_t count;
+};
+
+struct Entry
+{
+	uint32_t chksum;
+	uint32_t srcCrc;
+	std::string data;
+};
+
+}
+
+#define READ(ptr, size, n, f) if (fread(ptr, size, n, f) < n) return false
+
+static bool readCache(FILE *f, const std::string &tag, std::vector<Entry> &out)
+{
+	Header hd;
+	READ(&hd, sizeof(hd), 1, f);
+
+	if (memcmp(hd.magic, "MKXPSCRC", 8) != 0 || hd.formVer != FORMAT_VER)
+		return false;
+
+	if (hd.tagLen != tag.size() || hd.tagLen > MAX_TAG_LEN || hd.count > MAX_COUNT)
+		return false;
+
+	std::string fileTag(hd.tagLen, '\0');
+
+	if (hd.tagLen > 0)
+		READ(&fileTag[0], 1, hd.tagLen, f);
+
+	if (fileTag != tag)
+		return false;
+
+	out.resize(hd.count);
+
+	for (size_t i = 0; i < hd.count; ++i)
+	{
+		uint32_t size;
+
+		READ(&out[i].chksum, sizeof(uint32_t), 1, f);
+		READ(&out[i].srcCrc, sizeof(uint32_t), 1, f);
+		READ(&size, sizeof(uint32_t), 1, f);
+
+		if (size > MAX_DATA)
+			return false;
+
+		out[i].data.resize(size);
+
+		if (size > 0)
+			READ(&out[i].data[0], 1, size, f);
+	}
+
+	return true;
+}
+
+#undef READ
+
+struct ScriptCachePrivate
+{
+	std::string path;
+	std::string tag;
+	std::vector<Entry> entries;
+	bool dirty;
+
+	ScriptCachePrivate(const Config &conf, const std::string &tag, size_t scriptCount)
+	    : tag(tag),
+	      dirty(false)
+	{
+#ifndef __EMSCRIPTEN__
+		/* (On the web, nothing written here survives a reload) */
+		const std::string &dir = conf.customDataPath.empty()
+		        ? conf.commonDataPath : conf.customDataPath;
+
+		if (!dir.empty())
+		{
+			/* The common path is shared between games */
+			const std::string &title = conf.game.title;
+			const uLong titleCrc = crc32(0, (const Bytef*) title.c_str(), title.size());
+
+			char buf[32];
+			snprintf(buf, sizeof(buf), "scripts-%08lx.mkxpc", (unsigned long) titleCrc);
+
+			path = dir + buf;
+		}
+#else
+		(void) conf;
+#endif
+
+		if (!path.empty())
+			load();
+
+		if (entries.size() != scriptCount)
+		{
+			entries.resize(scriptCount);
+			dirty = true;
+		}
+	}
+
+	void load()
+	{
+		FILE *f = fopen(path.c_str(), "rb");
+
+		if (!f)
+			return;
+
+		if (!readCache(f, tag, entries))
+			entries.clear();
+
+		fclose(f);
+	}
+
+	void write()
+	{
+		/* Written aside and moved into place, so an interrupted
+		 * write can't leave a truncated cache behind */
+		const std::string tmpPath = path + ".tmp";
+		FILE *f = fopen(tmpPath.c_str(), "wb");
+
+		if (!f)
+			return;
+
+		Header hd;
+		memcpy(hd.magic, "MKXPSCRC", 8);
+		hd.formVer = FORMAT_VER;
+		hd.tagLen = tag.size();
+		hd.count = entries.size();
+
+		bool ok = fwrite(&hd, sizeof(hd), 1, f) == 1 &&
+		          fwrite(tag.data(), 1, tag.size(), f) == tag.size();
+
+		for (size_t i = 0; ok && i < entries.size(); ++i)
+		{
+			const Entry &e = entries[i];
+			const uint32_t size = e.data.size();
+
+			ok = fwrite(&e.chksum, sizeof(uint32_t), 1, f) == 1 &&
+			     fwrite(&e.srcCrc, sizeof(uint32_t), 1, f) == 1 &&
+			     fwrite(&size, sizeof(uint32_t), 1, f) == 1 &&
+			     fwrite(e.data.data(), 1, size, f) == size;
+		}
+
+		if (fclose(f) != 0)
+			ok = false;
+
+#ifdef _WIN32
+		/* rename() doesn't replace existing files here */
+		if (ok)
+			remove(path.c_str());
+#endif
+
+		if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0)
+		{
+			remove(tmpPath.c_str());
+			return;
+		}
+
+		Debug() << "Wrote compiled script cache" << path;
+	}
+};
+
+ScriptCache::ScriptCache(const Config &conf, const std::string &tag, size_t scriptCount)
+{
+	p = new ScriptCachePrivate(conf, tag, scriptCount);
+}
+
+ScriptCache::~ScriptCache()
+{
+	delete p;
+}
+
+const std::string *ScriptCache::lookup(size_t index, uint32_t chksum, uint32_t srcCrc) const
+{
+	if (index >= p->entries.size())
+		return 0;
+
+	const Entry &e = p->entries[index];
+
+	if (e.chksum != chksum || e.srcCrc != srcCrc || e.data.empty())
+		return 0;
+
+	return &e.data;
+}
+
+void ScriptCache::store(size_t index, uint32_t chksum, uint32_t srcCrc, const std::string &data)
+{
+	if (index >= p->entries.size())
+		return;
+
+	Entry &e = p->entries[index];
+	e.chksum = chksum;
+	e.srcCrc = srcCrc;
+	e.data = data;
+
+	p->dirty = true;
+}
+
+void ScriptCache::flush()
+{
+	if (!p->dirty || p->path.empty())
+		return;
+
+	p->write();
+	p->dirty = false;
+}
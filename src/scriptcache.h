@@ -0,0 +1,56 @@
+/*
+** scriptcache.h
+**
+** This file is part of mkxp.
+**
+** mkxp is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 2 of the License, or
+** (at your option) any later version.
+**
+** mkxp is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with mkxp.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef SCRIPTCACHE_H
+#define SCRIPTCACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string>
+
+struct Config;
+struct ScriptCachePrivate;
+
+/* On-disk cache of compiled game scripts (mruby irep or MRI
+ * ISeq binaries), one file per game in its data path.
+ *
+ * Entries are matched by position, script checksum and the CRC
+ * of the compressed source, as the checksum alone is not
+ * guaranteed to change when a script is edited. 'tag' names the
+ * compiler that produced the data; a cache written under any
+ * other tag is discarded as a whole */
+class ScriptCache
+{
+public:
+	ScriptCache(const Config &conf, const std::string &tag, size_t scriptCount);
+	~ScriptCache();
+
+	/* Null if there is no matching entry */
+	const std::string *lookup(size_t index, uint32_t chksum, uint32_t srcCrc) const;
+
+	void store(size_t index, uint32_t chksum, uint32_t srcCrc, const std::string &data);
+
+	/* Writes the cache back if anything changed */
+	void flush();
+
+private:
+	ScriptCachePrivate *p;
+};
+
+#endif // SCRIPTCACHE_H
@@ -23,9 +23,11 @@
 #include "sharedstate.h"
 #include "glstate.h"
 #include "exception.h"
+#include "programcache.h"
 
 #include <assert.h>
 #include <string.h>
+#include <zlib.h>
 #include <iostream>
 
 #include "common.h.xxd"
@@ -35,7 +37,7 @@
 #include "transSimple.frag.xxd"
 #include "bitmapBlit.frag.xxd"
 #include "plane.frag.xxd"
-#include "gray.frag.xxd"
+#include "viewport.frag.xxd"
 #include "flatColor.frag.xxd"
 #include "simple.frag.xxd"
 #include "simpleColor.frag.xxd"
@@ -62,6 +64,9 @@
 
 #define GET_U(name) u_##name = gl.GetUniformLocation(program, #name)
 
+/* Set while the ShaderSet exists */
+static ProgramCache *programCache = 0;
+
 static void printShaderLog(GLuint shader)
 {
 	GLint logLength;
@@ -111,6 +116,20 @@ void Shader::unbind()
 	glState.program.set(0);
 }
 
+/* Covers everything setupShaderSource() feeds the compiler */
+static uint32_t programSourceCrc(const unsigned char *vert, int vertSize,
+                                 const unsigned char *frag, int fragSize)
+{
+	const Bytef glsles = gl.glsles;
+
+	uLong crc = crc32(0, &glsles, 1);
+	crc = crc32(crc, shader_common_h, shader_common_h_len);
+	crc = crc32(crc, vert, vertSize);
+	crc = crc32(crc, frag, fragSize);
+
+	return crc;
+}
+
 static void setupShaderSource(GLuint shader, GLenum type,
                               const unsigned char *body, int bodySize)
 {
@@ -153,6 +172,11 @@ void Shader::init(const unsigned char *vert, int vertSize,
 {
 	GLint success;
 
+	const uint32_t srcCrc = programSourceCrc(vert, vertSize, frag, fragSize);
+
+	if (programCache && programCache->load(program, programName, srcCrc))
+		return;
+
 	/* Compile vertex shader */
 	setupShaderSource(vertShader, GL_VERTEX_SHADER, vert, vertSize);
 	gl.CompileShader(vertShader);
@@ -189,6 +213,9 @@ void Shader::init(const unsigned char *vert, int vertSize,
 	gl.BindAttribLocation(program, TexCoord, "texCoord");
 	gl.BindAttribLocation(program, Color, "color");
 
+	if (programCache && gl.ProgramParameteri)
+		gl.ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
 	gl.LinkProgram(program);
 
 	gl.GetProgramiv(program, GL_LINK_STATUS, &success);
@@ -200,6 +227,9 @@ void Shader::init(const unsigned char *vert, int vertSize,
 	                    "GLSL: An error occured while linking program '%s' (vertex '%s', fragment '%s')",
 	                    programName, vertName, fragName);
 	}
+
+	if (programCache)
+		programCache->store(program, programName, srcCrc);
 }
 
 void Shader::initFromFile(const char *_vertFile, const char *_fragFile,
@@ -498,18 +528,30 @@ void PlaneShader::setOpacity(float value)
 }
 
 
-GrayShader::GrayShader()
+ViewportShader::ViewportShader()
 {
-	INIT_SHADER(simple, gray, GrayShader);
+	INIT_SHADER(simple, viewport, ViewportShader);
 
 	ShaderBase::init();
 
-	GET_U(gray);
+	GET_U(tone);
+	GET_U(color);
+	GET_U(flash);
+}
+
+void ViewportShader::setTone(const Vec4 &tone)
+{
+	setVec4Uniform(u_tone, tone);
 }
 
-void GrayShader::setGray(float value)
+void ViewportShader::setColor(const Vec4 &color)
 {
-	gl.Uniform1f(u_gray, value);
+	setVec4Uniform(u_color, color);
+}
+
+void ViewportShader::setFlash(const Vec4 &flash)
+{
+	setVec4Uniform(u_flash, flash);
 }
 
 
@@ -635,3 +677,130 @@ void BltShader::setOpacity(float value)
 {
 	gl.Uniform1f(u_opacity, value);
 }
+
+
+struct ShaderSetPrivate
+{
+	ProgramCache cache;
+
+	FlatColorShader *flatColor;
+	SimpleShader *simple;
+	SimpleColorShader *simpleColor;
+	SimpleAlphaShader *simpleAlpha;
+	SimpleSpriteShader *simpleSprite;
+	AlphaSpriteShader *alphaSprite;
+	SpriteShader *sprite;
+	PlaneShader *plane;
+	ViewportShader *viewport;
+	TilemapShader *tilemap;
+	FlashMapShader *flashMap;
+	TransShader *trans;
+	SimpleTransShader *simpleTrans;
+	HueShader *hue;
+	BltShader *blt;
+	SimpleMatrixShader *simpleMatrix;
+	BlurShader *blur;
+	TilemapVXShader *tilemapVX;
+
+	ShaderSetPrivate(const Config &conf)
+	    : cache(conf),
+	      flatColor(0), simple(0), simpleColor(0), simpleAlpha(0),
+	      simpleSprite(0), alphaSprite(0), sprite(0), plane(0),
+	      viewport(0), tilemap(0), flashMap(0), trans(0),
+	      simpleTrans(0), hue(0), blt(0), simpleMatrix(0),
+	      blur(0), tilemapVX(0)
+	{}
+
+	~ShaderSetPrivate()
+	{
+		/* Programs created lazily since startup */
+		cache.flush();
+
+		delete flatColor;
+		delete simple;
+		delete simpleColor;
+		delete simpleAlpha;
+		delete simpleSprite;
+		delete alphaSprite;
+		delete sprite;
+		delete plane;
+		delete viewport;
+		delete tilemap;
+		delete flashMap;
+		delete trans;
+		delete simpleTrans;
+		delete hue;
+		delete blt;
+		delete simpleMatrix;
+		delete blur;
+		delete tilemapVX;
+	}
+
+	template<class S>
+	S &get(S *&shader)
+	{
+		/* Any newly linked program only marks the cache dirty;
+		 * rewriting it here would stall the frame that first
+		 * uses the shader. It is written back on shutdown */
+		if (!shader)
+			shader = new S;
+
+		return *shader;
+	}
+};
+
+ShaderSet::ShaderSet(const Config &conf)
+{
+	p = new ShaderSetPrivate(conf);
+	programCache = &p->cache;
+
+	try
+	{
+		/* What nearly every frame draws with */
+		simple();
+		simpleColor();
+		simpleAlpha();
+		simpleSprite();
+		sprite();
+		blt();
+
+		p->cache.flush();
+	}
+	catch (...)
+	{
+		programCache = 0;
+		delete p;
+		throw;
+	}
+}
+
+ShaderSet::~ShaderSet()
+{
+	programCache = 0;
+	delete p;
+}
+
+#define SHADER_GETTER(type, name) \
+	type &ShaderSet::name() \
+	{ \
+		return p->get(p->name); \
+	}
+
+SHADER_GETTER(FlatColorShader, flatColor)
+SHADER_GETTER(SimpleShader, simple)
+SHADER_GETTER(SimpleColorShader, simpleColor)
+SHADER_GETTER(SimpleAlphaShader, simpleAlpha)
+SHADER_GETTER(SimpleSpriteShader, simpleSprite)
+SHADER_GETTER(AlphaSpriteShader, alphaSprite)
+SHADER_GETTER(SpriteShader, sprite)
+SHADER_GETTER(PlaneShader, plane)
+SHADER_GETTER(ViewportShader, viewport)
+SHADER_GETTER(TilemapShader, tilemap)
+SHADER_GETTER(FlashMapShader, flashMap)
+SHADER_GETTER(TransShader, trans)
+SHADER_GETTER(SimpleTransShader, simpleTrans)
+SHADER_GETTER(HueShader, hue)
+SHADER_GETTER(BltShader, blt)
+SHADER_GETTER(SimpleMatrixShader, simpleMatrix)
+SHADER_GETTER(BlurShader, blur)
+SHADER_GETTER(TilemapVXShader, tilemapVX)
@@ -202,15 +202,19 @@ private:
 	GLint u_tone, u_color, u_flash, u_opacity;
 };
 
-class GrayShader : public ShaderBase
+/* Applies a viewport's gray, tone, color and flash effects
+ * to a copy of the screen area it covers, in one pass */
+class ViewportShader : public ShaderBase
 {
 public:
-	GrayShader();
+	ViewportShader();
 
-	void setGray(float value);
+	void setTone(const Vec4 &value);
+	void setColor(const Vec4 &value);
+	void setFlash(const Vec4 &value);
 
 private:
-	GLint u_gray;
+	GLint u_tone, u_color, u_flash;
 };
 
 class TilemapShader : public ShaderBase
@@ -303,27 +307,39 @@ private:
 	GLint u_source, u_destination, u_subRect, u_opacity;
 };
 
-/* Global object containing all available shaders */
+struct Config;
+struct ShaderSetPrivate;
+
+/* Global object containing all available shaders. The ones
+ * nearly every scene draws with are built up front, the rest
+ * on first use. Linked programs are cached on disk where the
+ * driver allows it */
 struct ShaderSet
 {
-	FlatColorShader flatColor;
-	SimpleShader simple;
-	SimpleColorShader simpleColor;
-	SimpleAlphaShader simpleAlpha;
-	SimpleSpriteShader simpleSprite;
-	AlphaSpriteShader alphaSprite;
-	SpriteShader sprite;
-	PlaneShader plane;
-	GrayShader gray;
-	TilemapShader tilemap;
-	FlashMapShader flashMap;
-	TransShader trans;
-	SimpleTransShader simpleTrans;
-	HueShader hue;
-	BltShader blt;
-	SimpleMatrixShader simpleMatrix;
-	BlurShader blur;
-	TilemapVXShader tilemapVX;
+	ShaderSet(const Config &conf);
+	~ShaderSet();
+
+	FlatColorShader &flatColor();
+	SimpleShader &simple();
+	SimpleColorShader &simpleColor();
+	SimpleAlphaShader &simpleAlpha();
+	SimpleSpriteShader &simpleSprite();
+	AlphaSpriteShader &alphaSprite();
+	SpriteShader &sprite();
+	PlaneShader &plane();
+	ViewportShader &viewport();
+	TilemapShader &tilemap();
+	FlashMapShader &flashMap();
+	TransShader &trans();
+	SimpleTransShader &simpleTrans();
+	HueShader &hue();
+	BltShader &blt();
+	SimpleMatrixShader &simpleMatrix();
+	BlurShader &blur();
+	TilemapVXShader &tilemapVX();
+
+private:
+	ShaderSetPrivate *p;
 };
 
 #endif // SHADER_H
@@ -29,6 +29,8 @@
 #include "glstate.h"
 #include "shader.h"
 #include "texpool.h"
+#include "prefetcher.h"
+#include "savewriter.h"
 #include "font.h"
 #include "eventthread.h"
 #include "gl-util.h"
@@ -37,6 +39,11 @@
 #include "binding.h"
 #include "exception.h"
 #include "sharedmidistate.h"
+#include "bundle.h"
+
+#ifdef __EMSCRIPTEN__
+#include "emscripten.hpp"
+#endif
 
 #include <unistd.h>
 #include <stdio.h>
@@ -46,6 +53,9 @@ SharedState *SharedState::instance = 0;
 int SharedState::rgssVersion = 0;
 static GlobalIBO *_globalIBO = 0;
 
+/* Number of general purpose TexFBOs handed out in turn */
+#define GP_TEXFBO_COUNT 4
+
 static const char *gameArchExt()
 {
 	if (rgssVer == 1)
@@ -83,6 +93,10 @@ struct SharedStatePrivate
 
 	TexPool texPool;
 
+	Prefetcher prefetcher;
+
+	SaveWriter saveWriter;
+
 	SharedFontState fontState;
 	Font *defaultFont;
 
@@ -90,9 +104,14 @@ struct SharedStatePrivate
 	int globalTexW, globalTexH;
 	bool globalTexDirty;
 
-	TEXFBO gpTexFBO;
+	/* Ring of general purpose TexFBOs; consecutive users get
+	 * different objects, so the driver doesn't have to wait
+	 * for pending draws on one texture before reusing it */
+	TEXFBO gpTexFBO[GP_TEXFBO_COUNT];
+	size_t gpTexFBOIdx;
 
 	TEXFBO atlasTex;
+	AtlasKey atlasKey;
 
 	Quad gpQuad;
 
@@ -110,10 +129,15 @@ struct SharedStatePrivate
 	      input(*threadData),
 	      audio(*threadData),
 	      _glState(threadData->config),
+	      shaders(threadData->config),
+	      texPool(threadData->config.texPoolSize * 1000000),
+	      prefetcher(threadData->config),
 	      fontState(threadData->config),
-	      stampCounter(0)
+	      gpTexFBOIdx(0),
+	      stampCounter(1)
 	{
-		/* Shaders have been compiled in ShaderSet's constructor */
+		/* The common shaders have been compiled in ShaderSet's
+		 * constructor; the compiler is reloaded for the rest */
 		if (gl.ReleaseShaderCompiler)
 			gl.ReleaseShaderCompiler();
 
@@ -127,6 +151,18 @@ struct SharedStatePrivate
 			fclose(tmp);
 		}
 
+		/* Check for an asset bundle, which shadows the loose files */
+		tmp = fopen(BUNDLE_INDEX_PATH, "rb");
+		if (tmp)
+		{
+			fclose(tmp);
+#ifdef __EMSCRIPTEN__
+			/* Replace the placeholder with the actual index */
+			load_file_async_js(BUNDLE_INDEX_PATH);
+#endif
+			fileSystem.addPath(BUNDLE_INDEX_PATH);
+		}
+
 		fileSystem.addPath(".");
 
 		for (size_t i = 0; i < config.rtps.size(); ++i)
@@ -147,10 +183,13 @@ struct SharedStatePrivate
 		TEX::allocEmpty(globalTexW, globalTexH);
 		globalTexDirty = false;
 
-		TEXFBO::init(gpTexFBO);
-		/* Reuse starting values */
-		TEXFBO::allocEmpty(gpTexFBO, globalTexW, globalTexH);
-		TEXFBO::linkFBO(gpTexFBO);
+		for (size_t i = 0; i < GP_TEXFBO_COUNT; ++i)
+		{
+			TEXFBO::init(gpTexFBO[i]);
+			/* Reuse starting values */
+			TEXFBO::allocEmpty(gpTexFBO[i], globalTexW, globalTexH);
+			TEXFBO::linkFBO(gpTexFBO[i]);
+		}
 
 #ifndef __EMSCRIPTEN__
 		/* RGSS3 games will call setup_midi, so there's
@@ -163,7 +202,10 @@ struct SharedStatePrivate
 	~SharedStatePrivate()
 	{
 		TEX::del(globalTex);
-		TEXFBO::fini(gpTexFBO);
+
+		for (size_t i = 0; i < GP_TEXFBO_COUNT; ++i)
+			TEXFBO::fini(gpTexFBO[i]);
+
 		TEXFBO::fini(atlasTex);
 	}
 };
@@ -233,6 +275,8 @@ GSATT(Audio&, audio)
 GSATT(GLState&, _glState)
 GSATT(ShaderSet&, shaders)
 GSATT(TexPool&, texPool)
+GSATT(Prefetcher&, prefetcher)
+GSATT(SaveWriter&, saveWriter)
 GSATT(Quad&, gpQuad)
 GSATT(SharedFontState&, fontState)
 GSATT(SharedMidiState&, midiState)
@@ -265,12 +309,13 @@ void SharedState::bindTex()
 
 void SharedState::ensureTexSize(int minW, int minH, Vec2i &currentSizeOut)
 {
+	/* Only ever grow; users only touch the sub rectangle they need */
 	minW = findNextPow2(minW); minH = findNextPow2(minH);
 
-	if (minW != p->globalTexW || minH != p->globalTexH)
+	if (minW > p->globalTexW || minH > p->globalTexH)
 	{
-		p->globalTexW = minW;
-		p->globalTexH = minH;
+		p->globalTexW = std::max(minW, p->globalTexW);
+		p->globalTexH = std::max(minH, p->globalTexH);
 		p->globalTexDirty = true;
 	}
 
@@ -279,20 +324,24 @@ void SharedState::ensureTexSize(int minW, int minH, Vec2i &currentSizeOut)
 
 TEXFBO &SharedState::gpTexFBO(int minW, int minH)
 {
+	TEXFBO &obj = p->gpTexFBO[p->gpTexFBOIdx];
+	p->gpTexFBOIdx = (p->gpTexFBOIdx + 1) % GP_TEXFBO_COUNT;
+
+	/* Only ever grow; users only touch the sub rectangle they need */
 	minW = findNextPow2(minW); minH = findNextPow2(minH);
 
-	if (minW != p->gpTexFBO.width || minH != p->gpTexFBO.height)
+	if (minW > obj.width || minH > obj.height)
 	{
-		p->gpTexFBO.width = minW;
-		p->gpTexFBO.height = minH;
-		TEX::bind(p->gpTexFBO.tex);
-		TEX::allocEmpty(p->gpTexFBO.width, p->gpTexFBO.height);
+		obj.width = std::max(minW, obj.width);
+		obj.height = std::max(minH, obj.height);
+		TEX::bind(obj.tex);
+		TEX::allocEmpty(obj.width, obj.height);
 	}
 
-	return p->gpTexFBO;
+	return obj;
 }
 
-void SharedState::requestAtlasTex(int w, int h, TEXFBO &out)
+void SharedState::requestAtlasTex(int w, int h, TEXFBO &out, AtlasKey *key)
 {
 	TEXFBO tex;
 
@@ -300,18 +349,26 @@ void SharedState::requestAtlasTex(int w, int h, TEXFBO &out)
 	{
 		tex = p->atlasTex;
 		p->atlasTex = TEXFBO();
+
+		if (key)
+			key->swap(p->atlasKey);
 	}
 	else
 	{
 		TEXFBO::init(tex);
 		TEXFBO::allocEmpty(tex, w, h);
 		TEXFBO::linkFBO(tex);
+
+		if (key)
+			key->clear();
 	}
 
+	p->atlasKey.clear();
+
 	out = tex;
 }
 
-void SharedState::releaseAtlasTex(TEXFBO &tex)
+void SharedState::releaseAtlasTex(TEXFBO &tex, const AtlasKey &key)
 {
 	/* No point in caching an invalid object */
 	if (tex.tex == TEX::ID(0))
@@ -320,6 +377,7 @@ void SharedState::releaseAtlasTex(TEXFBO &tex)
 	TEXFBO::fini(p->atlasTex);
 
 	p->atlasTex = tex;
+	p->atlasKey = key;
 }
 
 void SharedState::checkShutdown()
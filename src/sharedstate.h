@@ -24,6 +24,9 @@
 
 #include <sigc++/signal.h>
 
+#include <stdint.h>
+#include <vector>
+
 #define shState SharedState::instance
 #define glState shState->_glState()
 #define rgssVer SharedState::rgssVersion
@@ -44,6 +47,8 @@ class Input;
 class Audio;
 class GLState;
 class TexPool;
+class Prefetcher;
+class SaveWriter;
 class Font;
 class SharedFontState;
 struct GlobalIBO;
@@ -51,6 +56,9 @@ struct Config;
 struct Vec2i;
 struct SharedMidiState;
 
+/* Content stamps of the bitmaps a tile atlas was built from */
+typedef std::vector<uint64_t> AtlasKey;
+
 struct SharedState
 {
 	void *bindingData() const;
@@ -77,6 +85,10 @@ struct SharedState
 
 	TexPool &texPool() const;
 
+	Prefetcher &prefetcher() const;
+
+	SaveWriter &saveWriter() const;
+
 	SharedFontState &fontState() const;
 	Font &defaultFont() const;
 
@@ -84,6 +96,7 @@ struct SharedState
 
 	sigc::signal<void> prepareDraw;
 
+	/* Monotonic, starting at 1 */
 	unsigned int genTimeStamp();
 
 	/* Returns global quad IBO, and ensures it has indices
@@ -95,14 +108,20 @@ struct SharedState
 	void bindTex();
 	void ensureTexSize(int minW, int minH, Vec2i &currentSizeOut);
 
+	/* Returns a scratch TexFBO of at least (minW, minH). Objects
+	 * are handed out round robin from a small ring and never shrink,
+	 * so the returned one may be bigger than requested */
 	TEXFBO &gpTexFBO(int minW, int minH);
 
 	Quad &gpQuad() const;
 
 	/* Basically just a simple "TexPool"
-	 * replacement for Tilemap atlas use */
-	void requestAtlasTex(int w, int h, TEXFBO &out);
-	void releaseAtlasTex(TEXFBO &tex);
+	 * replacement for Tilemap atlas use. Released atlases
+	 * keep their contents; 'key' describes them (empty if
+	 * unknown), so a tilemap assembling the same atlas
+	 * again can skip building it */
+	void requestAtlasTex(int w, int h, TEXFBO &out, AtlasKey *key = 0);
+	void releaseAtlasTex(TEXFBO &tex, const AtlasKey &key = AtlasKey());
 
 	/* Checks EventThread's shutdown request flag and if set,
 	 * requests the binding to terminate. In this case, this
@@ -23,6 +23,7 @@
 
 #include "sharedstate.h"
 #include "filesystem.h"
+#include "prefetcher.h"
 #include "exception.h"
 #include "config.h"
 #include "util.h"
@@ -249,6 +250,8 @@ SoundBuffer *SoundEmitter::allocateBuffer(const std::string &filename)
 	else
 	{
 		/* Buffer not in cache, needs to be loaded */
+		shState->prefetcher().demand(filename.c_str());
+
 #ifdef __EMSCRIPTEN__
 		load_file_async_js(filename.c_str());
 #endif
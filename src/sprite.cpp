@@ -45,7 +45,11 @@
 
 struct SpritePrivate
 {
+	Sprite *self;
+
 	Bitmap *bitmap;
+	sigc::connection bitmapCon;
+	sigc::connection bitmapDispCon;
 
 	Quad quad;
 	Transform trans;
@@ -69,6 +73,8 @@ struct SpritePrivate
 
 	Color *color;
 	Tone *tone;
+	sigc::connection colorCon;
+	sigc::connection toneCon;
 
 	struct
 	{
@@ -88,8 +94,9 @@ struct SpritePrivate
 
 	sigc::connection prepareCon;
 
-	SpritePrivate()
-	    : bitmap(0),
+	SpritePrivate(Sprite *self)
+	    : self(self),
+	      bitmap(0),
 	      srcRect(&tmp.rect),
 	      mirrored(false),
 	      bushDepth(0),
@@ -105,6 +112,7 @@ struct SpritePrivate
 		sceneRect.x = sceneRect.y = 0;
 
 		updateSrcRectCon();
+		updateColorToneCons();
 
 		prepareCon = shState->prepareDraw.connect
 		        (sigc::mem_fun(this, &SpritePrivate::prepare));
@@ -119,20 +127,33 @@ struct SpritePrivate
 	~SpritePrivate()
 	{
 		srcRectCon.disconnect();
+		colorCon.disconnect();
+		toneCon.disconnect();
+		bitmapCon.disconnect();
+		bitmapDispCon.disconnect();
 		prepareCon.disconnect();
 	}
 
+	void notifyChange()
+	{
+		self->notifyChange();
+	}
+
 	void recomputeBushDepth()
 	{
 		if (nullOrDisposed(bitmap))
 			return;
 
+		/* Normalized against the backing texture,
+		 * which may be bigger than the bitmap */
+		float texH = bitmap->getGLTypes().height;
+
 		/* Calculate effective (normalized) bush depth */
 		float texBushDepth = (bushDepth / trans.getScale().y) -
 		                     (srcRect->y + srcRect->height) +
-		                     bitmap->height();
+		                     texH;
 
-		efBushDepth = 1.0f - texBushDepth / bitmap->height();
+		efBushDepth = 1.0f - texBushDepth / texH;
 	}
 
 	void onSrcRectChange()
@@ -154,6 +175,7 @@ struct SpritePrivate
 		recomputeBushDepth();
 
 		wave.dirty = true;
+		notifyChange();
 	}
 
 	void updateSrcRectCon()
@@ -165,6 +187,31 @@ struct SpritePrivate
 				(sigc::mem_fun(this, &SpritePrivate::onSrcRectChange));
 	}
 
+	void updateColorToneCons()
+	{
+		colorCon.disconnect();
+		colorCon = color->valueChanged.connect
+				(sigc::mem_fun(this, &SpritePrivate::notifyChange));
+
+		toneCon.disconnect();
+		toneCon = tone->valueChanged.connect
+				(sigc::mem_fun(this, &SpritePrivate::notifyChange));
+	}
+
+	void updateBitmapCons()
+	{
+		bitmapCon.disconnect();
+		bitmapDispCon.disconnect();
+
+		if (nullOrDisposed(bitmap))
+			return;
+
+		bitmapCon = bitmap->modified.connect
+				(sigc::mem_fun(this, &SpritePrivate::notifyChange));
+		bitmapDispCon = bitmap->wasDisposed.connect
+				(sigc::mem_fun(this, &SpritePrivate::notifyChange));
+	}
+
 	void updateVisibility()
 	{
 		isVisible = false;
@@ -301,7 +348,7 @@ struct SpritePrivate
 Sprite::Sprite(Viewport *viewport)
     : ViewportElement(viewport)
 {
-	p = new SpritePrivate;
+	p = new SpritePrivate(this);
 	onGeometryChange(scene->getGeometry());
 }
 
@@ -328,8 +375,9 @@ DEF_ATTR_RD_SIMPLE(Sprite, WaveLength, int,     p->wave.length)
 DEF_ATTR_RD_SIMPLE(Sprite, WaveSpeed,  int,     p->wave.speed)
 DEF_ATTR_RD_SIMPLE(Sprite, WavePhase,  float,   p->wave.phase)
 
-DEF_ATTR_SIMPLE(Sprite, BushOpacity, int,     p->bushOpacity)
-DEF_ATTR_SIMPLE(Sprite, Opacity,     int,     p->opacity)
+DEF_ATTR_RD_SIMPLE(Sprite, BushOpacity, int, p->bushOpacity)
+DEF_ATTR_RD_SIMPLE(Sprite, Opacity,     int, p->opacity)
+
 DEF_ATTR_SIMPLE(Sprite, SrcRect,     Rect&,  *p->srcRect)
 DEF_ATTR_SIMPLE(Sprite, Color,       Color&, *p->color)
 DEF_ATTR_SIMPLE(Sprite, Tone,        Tone&,  *p->tone)
@@ -342,6 +390,8 @@ void Sprite::setBitmap(Bitmap *bitmap)
 		return;
 
 	p->bitmap = bitmap;
+	p->updateBitmapCons();
+	notifyChange();
 
 	if (nullOrDisposed(bitmap))
 		return;
@@ -363,6 +413,7 @@ void Sprite::setX(int value)
 		return;
 
 	p->trans.setPosition(Vec2(value, getY()));
+	notifyChange();
 }
 
 void Sprite::setY(int value)
@@ -373,6 +424,7 @@ void Sprite::setY(int value)
 		return;
 
 	p->trans.setPosition(Vec2(getX(), value));
+	notifyChange();
 
 	if (rgssVer >= 2)
 	{
@@ -389,6 +441,7 @@ void Sprite::setOX(int value)
 		return;
 
 	p->trans.setOrigin(Vec2(value, getOY()));
+	notifyChange();
 }
 
 void Sprite::setOY(int value)
@@ -399,6 +452,7 @@ void Sprite::setOY(int value)
 		return;
 
 	p->trans.setOrigin(Vec2(getOX(), value));
+	notifyChange();
 }
 
 void Sprite::setZoomX(float value)
@@ -409,6 +463,7 @@ void Sprite::setZoomX(float value)
 		return;
 
 	p->trans.setScale(Vec2(value, getZoomY()));
+	notifyChange();
 }
 
 void Sprite::setZoomY(float value)
@@ -420,6 +475,7 @@ void Sprite::setZoomY(float value)
 
 	p->trans.setScale(Vec2(getZoomX(), value));
 	p->recomputeBushDepth();
+	notifyChange();
 
 	if (rgssVer >= 2)
 		p->wave.dirty = true;
@@ -433,6 +489,7 @@ void Sprite::setAngle(float value)
 		return;
 
 	p->trans.setRotation(value);
+	notifyChange();
 }
 
 void Sprite::setMirror(bool mirrored)
@@ -455,6 +512,29 @@ void Sprite::setBushDepth(int value)
 
 	p->bushDepth = value;
 	p->recomputeBushDepth();
+	notifyChange();
+}
+
+void Sprite::setBushOpacity(int value)
+{
+	guardDisposed();
+
+	if (p->bushOpacity == value)
+		return;
+
+	p->bushOpacity = value;
+	notifyChange();
+}
+
+void Sprite::setOpacity(int value)
+{
+	guardDisposed();
+
+	if (p->opacity == value)
+		return;
+
+	p->opacity = value;
+	notifyChange();
 }
 
 void Sprite::setBlendType(int type)
@@ -466,14 +546,16 @@ void Sprite::setBlendType(int type)
 	default :
 	case BlendNormal :
 		p->blendType = BlendNormal;
-		return;
+		break;
 	case BlendAddition :
 		p->blendType = BlendAddition;
-		return;
+		break;
 	case BlendSubstraction :
 		p->blendType = BlendSubstraction;
-		return;
+		break;
 	}
+
+	notifyChange();
 }
 
 #define DEF_WAVE_SETTER(Name, name, type) \
@@ -484,6 +566,7 @@ void Sprite::setBlendType(int type)
 			return; \
 		p->wave.name = value; \
 		p->wave.dirty = true; \
+		notifyChange(); \
 	}
 
 DEF_WAVE_SETTER(Amp,    amp,    int)
@@ -500,6 +583,7 @@ void Sprite::initDynAttribs()
 	p->tone = new Tone;
 
 	p->updateSrcRectCon();
+	p->updateColorToneCons();
 }
 
 /* Flashable */
@@ -511,6 +595,9 @@ void Sprite::update()
 
 	p->wave.phase += p->wave.speed / 180;
 	p->wave.dirty = true;
+
+	if (p->wave.amp != 0)
+		notifyChange();
 }
 
 /* SceneElement */
@@ -531,7 +618,7 @@ void Sprite::draw()
 
 	if (renderEffect)
 	{
-		SpriteShader &shader = shState->shaders().sprite;
+		SpriteShader &shader = shState->shaders().sprite();
 
 		shader.bind();
 		shader.applyViewportProj();
@@ -553,7 +640,7 @@ void Sprite::draw()
 	}
 	else if (p->opacity != 255)
 	{
-		AlphaSpriteShader &shader = shState->shaders().alphaSprite;
+		AlphaSpriteShader &shader = shState->shaders().alphaSprite();
 		shader.bind();
 
 		shader.setSpriteMat(p->trans.getMatrix());
@@ -563,7 +650,7 @@ void Sprite::draw()
 	}
 	else
 	{
-		SimpleSpriteShader &shader = shState->shaders().simpleSprite;
+		SimpleSpriteShader &shader = shState->shaders().simpleSprite();
 		shader.bind();
 
 		shader.setSpriteMat(p->trans.getMatrix());
@@ -583,6 +670,42 @@ void Sprite::draw()
 	glState.blendMode.pop();
 }
 
+bool Sprite::getCullBounds(IntRect &bounds, bool &opaque) const
+{
+	/* Same opt outs as updateVisibility() */
+	if (!p->isVisible || p->wave.active)
+		return false;
+
+	const Vec2 &scale = p->trans.getScale();
+	if (scale.x != 1 || scale.y != 1 || p->trans.getRotation() != 0)
+		return false;
+
+	const IntRect src = p->srcRect->toIntRect();
+
+	bounds.setPos(p->trans.getPositionI() - (p->trans.getOriginI() + p->sceneOrig));
+	bounds.w = clamp<int>(src.w, 0, p->bitmap->width() - src.x);
+	bounds.h = clamp<int>(src.h, 0, p->bitmap->height() - src.y);
+
+	opaque = p->bitmap->isOpaque()         &&
+	         src.x >= 0 && src.y >= 0      &&
+	         p->opacity == 255             &&
+	         p->blendType == BlendNormal   &&
+	         p->bushDepth == 0             &&
+	         !emptyFlashFlag;
+
+	return true;
+}
+
+bool Sprite::blendsNormally() const
+{
+	return p->blendType == BlendNormal;
+}
+
+void Sprite::onFlashChange()
+{
+	notifyChange();
+}
+
 void Sprite::onGeometryChange(const Scene::Geometry &geo)
 {
 	/* Offset at which the sprite will be drawn
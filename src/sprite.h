@@ -74,6 +74,9 @@ private:
 
 	void draw();
 	void onGeometryChange(const Scene::Geometry &);
+	bool getCullBounds(IntRect &bounds, bool &opaque) const;
+	bool blendsNormally() const;
+	void onFlashChange();
 
 	void releaseResources();
 	const char *klassName() const { return "sprite"; }
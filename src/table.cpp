@@ -28,17 +28,27 @@
 #include "exception.h"
 #include "util.h"
 
+/* Tables with pending 'modified' emissions */
+static IntruList<Table> dirtyTables;
+
 /* Init normally */
 Table::Table(int x, int y /*= 1*/, int z /*= 1*/)
     : xs(x), ys(y), zs(z),
-      data(x*y*z)
+      data(x*y*z),
+      dirtyLink(this)
 {}
 
 Table::Table(const Table &other)
     : xs(other.xs), ys(other.ys), zs(other.zs),
-      data(other.data)
+      data(other.data),
+      dirtyLink(this)
 {}
 
+Table::~Table()
+{
+	dirtyTables.remove(dirtyLink);
+}
+
 int16_t Table::get(int x, int y, int z) const
 {
 	return data[xs*ys*z + xs*y + x];
@@ -55,7 +65,140 @@ void Table::set(int16_t value, int x, int y, int z)
 
 	data[xs*ys*z + xs*y + x] = value;
 
-	modified();
+	markDirty(IntRect(x, y, 1, 1));
+}
+
+/* Clips 'rect' against a table of size 'xs' * 'ys',
+ * returns false if nothing remains */
+static bool clipRect(IntRect &rect, int xs, int ys)
+{
+	int x2 = std::min(rect.x + rect.w, xs);
+	int y2 = std::min(rect.y + rect.h, ys);
+
+	rect.x = std::max(rect.x, 0);
+	rect.y = std::max(rect.y, 0);
+	rect.w = x2 - rect.x;
+	rect.h = y2 - rect.y;
+
+	return rect.w > 0 && rect.h > 0;
+}
+
+void Table::fill(int16_t value, const IntRect &rect, int z)
+{
+	IntRect r = rect;
+
+	if (z < 0 || z >= zs || !clipRect(r, xs, ys))
+		return;
+
+	for (int y = r.y; y < r.y + r.h; ++y)
+	{
+		int16_t *row = &at(r.x, y, z);
+		std::fill(row, row + r.w, value);
+	}
+
+	markDirty(r);
+}
+
+void Table::blit(const Table &src, const IntRect &rect, int dx, int dy)
+{
+	IntRect r = rect;
+
+	if (!clipRect(r, src.xs, src.ys))
+		return;
+
+	dx += r.x - rect.x;
+	dy += r.y - rect.y;
+
+	/* Clip against destination */
+	IntRect d(dx, dy, r.w, r.h);
+
+	if (!clipRect(d, xs, ys))
+		return;
+
+	r.x += d.x - dx;
+	r.y += d.y - dy;
+
+	const int zCount = std::min(zs, src.zs);
+
+	for (int z = 0; z < zCount; ++z)
+	{
+		/* Copy rows in an order that is safe
+		 * for overlapping blits within one table */
+		const bool up = (&src == this && d.y > r.y);
+
+		for (int i = 0; i < d.h; ++i)
+		{
+			int j = up ? d.h - 1 - i : i;
+
+			memmove(&at(d.x, d.y + j, z), &src.at(r.x, r.y + j, z),
+			        d.w * sizeof(int16_t));
+		}
+	}
+
+	if (zCount > 0)
+		markDirty(d);
+}
+
+int Table::replaceAll(int16_t from, int16_t to)
+{
+	int count = 0;
+
+	for (size_t i = 0; i < data.size(); ++i)
+	{
+		if (data[i] != from)
+			continue;
+
+		data[i] = to;
+		++count;
+	}
+
+	if (count > 0)
+		markDirty(IntRect(0, 0, xs, ys));
+
+	return count;
+}
+
+void Table::readRaw(char *out) const
+{
+	memcpy(out, dataPtr(data), rawSize());
+}
+
+void Table::writeRaw(const char *in)
+{
+	memcpy(dataPtr(data), in, rawSize());
+
+	if (!data.empty())
+		markDirty(IntRect(0, 0, xs, ys));
+}
+
+void Table::markDirty(const IntRect &rect)
+{
+	if (!dirtyLink.next)
+	{
+		dirtyRect = rect;
+		dirtyTables.append(dirtyLink);
+
+		return;
+	}
+
+	int x2 = std::max(dirtyRect.x + dirtyRect.w, rect.x + rect.w);
+	int y2 = std::max(dirtyRect.y + dirtyRect.h, rect.y + rect.h);
+
+	dirtyRect.x = std::min(dirtyRect.x, rect.x);
+	dirtyRect.y = std::min(dirtyRect.y, rect.y);
+	dirtyRect.w = x2 - dirtyRect.x;
+	dirtyRect.h = y2 - dirtyRect.y;
+}
+
+void Table::emitModified()
+{
+	while (!dirtyTables.isEmpty())
+	{
+		Table *t = dirtyTables.begin()->data;
+		dirtyTables.remove(t->dirtyLink);
+
+		t->modified();
+	}
 }
 
 void Table::resize(int x, int y, int z)
@@ -76,6 +219,10 @@ void Table::resize(int x, int y, int z)
 	ys = y;
 	zs = z;
 
+	/* Pending changes may lie outside the new bounds */
+	if (dirtyLink.next)
+		dirtyRect = IntRect(0, 0, xs, ys);
+
 	return;
 }
 
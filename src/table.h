@@ -23,6 +23,8 @@
 #define TABLE_H
 
 #include "serializable.h"
+#include "etc-internal.h"
+#include "intrulist.h"
 
 #include <stdint.h>
 #include <sigc++/signal.h>
@@ -34,7 +36,7 @@ public:
 	Table(int x, int y = 1, int z = 1);
 	/* Clone constructor */
 	Table(const Table &other);
-	virtual ~Table() {}
+	virtual ~Table();
 
 	int xSize() const { return xs; }
 	int ySize() const { return ys; }
@@ -47,6 +49,22 @@ public:
 	void resize(int x, int y);
 	void resize(int x);
 
+	/* Bulk operations; each counts as a single modification.
+	 * Rects are clipped against the table bounds. */
+	void fill(int16_t value, const IntRect &rect, int z);
+	/* Copies 'rect' of all (common) z layers of 'src' to
+	 * (dx, dy); 'src' may be this table */
+	void blit(const Table &src, const IntRect &rect, int dx, int dy);
+	/* Returns the number of replaced cells */
+	int replaceAll(int16_t from, int16_t to);
+
+	/* Cell data as packed native-endian int16 values,
+	 * x varying fastest, then y, then z */
+	int rawSize() const { return xs*ys*zs*sizeof(int16_t); }
+	void readRaw(char *out) const;
+	/* 'in' must hold rawSize() bytes */
+	void writeRaw(const char *in);
+
 	int serialSize() const;
 	void serialize(char *buffer) const;
 	static Table *deserialize(const char *data, int len);
@@ -62,11 +80,26 @@ public:
 		return data[xs*ys*z + xs*y + x];
 	}
 
+	/* Emitted at most once per frame, with all cell
+	 * writes since the last emission coalesced */
 	sigc::signal<void> modified;
 
+	/* Bounding box (x/y, all z) of the cells written to since
+	 * the last emission; only meaningful inside 'modified' handlers */
+	const IntRect &changedRect() const { return dirtyRect; }
+
+	/* Emits 'modified' for every table written to
+	 * since the last call; called once before drawing */
+	static void emitModified();
+
 private:
+	void markDirty(const IntRect &rect);
+
 	int xs, ys, zs;
 	std::vector<int16_t> data;
+
+	IntRect dirtyRect;
+	IntruListLink<Table> dirtyLink;
 };
 
 #endif // TABLE_H
@@ -24,9 +24,12 @@
 #include "sharedstate.h"
 #include "glstate.h"
 #include "boost-hash.h"
+#include "intrulist.h"
+#include "util.h"
 #include "debugwriter.h"
 
-#include <list>
+#include <SDL_timer.h>
+
 #include <utility>
 #include <assert.h>
 #include <string.h>
@@ -38,26 +41,53 @@ static uint32_t byteCount(Size &s)
 	return s.first * s.second * 4;
 }
 
+/* Rounds a texture dimension up to its size class. Between two
+ * powers of two, classes are spaced in quarter steps (ie. 1.25x,
+ * 1.5x, 1.75x of the lower one), so at most 25% of each axis is
+ * wasted while nearby sizes (eg. 33x17 and 40x20) share textures.
+ * Powers of two always map onto themselves */
+static int sizeClass(int value)
+{
+	int upper = findNextPow2(value);
+	int lower = upper / 2;
+	int step = lower / 4;
+
+	if (step < 1)
+		return value;
+
+	return lower + ((value - lower + step - 1) / step) * step;
+}
+
+struct CacheNode;
+typedef IntruList<CacheNode> CNodeList;
+
 struct CacheNode
 {
 	TEXFBO obj;
-	std::list<TEXFBO>::iterator prioIter;
 
-	bool operator==(const CacheNode &o) const
-	{
-		return obj == o.obj;
-	}
-};
+	/* Link into the global priority queue */
+	IntruListLink<CacheNode> prioLink;
 
-typedef std::list<CacheNode> CNodeList;
+	/* Link into the bucket of same sized objects */
+	IntruListLink<CacheNode> bucketLink;
+	CNodeList *bucket;
+
+	CacheNode(const TEXFBO &obj, CNodeList *bucket)
+	    : obj(obj),
+	      prioLink(this),
+	      bucketLink(this),
+	      bucket(bucket)
+	{}
+};
 
 struct TexPoolPrivate
 {
-	/* Contains all cached TexFBOs, grouped by size */
+	/* Contains all cached TexFBOs, grouped by size class */
 	BoostHash<Size, CNodeList> poolHash;
 
-	/* Contains all cached TexFBOs, sorted by release time */
-	std::list<TEXFBO> priorityQueue;
+	/* Contains all cached TexFBOs, sorted by release time
+	 * (most recently released ones at the front) */
+	CNodeList priorityQueue;
 
 	/* Maximal allowed cache memory */
 	const uint32_t maxMemSize;
@@ -71,12 +101,57 @@ struct TexPoolPrivate
 	/* Has this pool been disabled? */
 	bool disabled;
 
+	/* Tuning statistics */
+	uint32_t hits;
+	uint32_t misses;
+
+	uint32_t allocWindowStart;
+	uint32_t allocsInWindow;
+	uint32_t allocsPerSec;
+
 	TexPoolPrivate(uint32_t maxMemSize)
 	    : maxMemSize(maxMemSize),
 	      memSize(0),
 	      objCount(0),
-	      disabled(false)
+	      disabled(false),
+	      hits(0),
+	      misses(0),
+	      allocWindowStart(0),
+	      allocsInWindow(0),
+	      allocsPerSec(0)
 	{}
+
+	/* Unlinks 'node' from both lists and frees it,
+	 * returning the contained object */
+	TEXFBO take(CacheNode *node)
+	{
+		TEXFBO obj = node->obj;
+		Size size(obj.width, obj.height);
+
+		priorityQueue.remove(node->prioLink);
+		node->bucket->remove(node->bucketLink);
+		delete node;
+
+		memSize -= byteCount(size);
+		--objCount;
+
+		return obj;
+	}
+
+	void countAlloc()
+	{
+		uint32_t now = SDL_GetTicks();
+		uint32_t elapsed = now - allocWindowStart;
+
+		if (elapsed >= 1000)
+		{
+			allocsPerSec = (allocsInWindow * 1000) / elapsed;
+			allocsInWindow = 0;
+			allocWindowStart = now;
+		}
+
+		++allocsInWindow;
+	}
 };
 
 TexPool::TexPool(uint32_t maxMemSize)
@@ -86,15 +161,12 @@ TexPool::TexPool(uint32_t maxMemSize)
 
 TexPool::~TexPool()
 {
-	std::list<TEXFBO>::iterator iter;
+	CacheNode *node;
 
-	for (iter = p->priorityQueue.begin();
-	     iter != p->priorityQueue.end();
-	     ++iter)
+	while ((node = p->priorityQueue.tail()))
 	{
-		TEXFBO obj = *iter;
+		TEXFBO obj = p->take(node);
 		TEXFBO::fini(obj);
-		--p->objCount;
 	}
 
 	assert(p->objCount == 0);
@@ -104,42 +176,41 @@ TexPool::~TexPool()
 
 TEXFBO TexPool::request(int width, int height)
 {
-	CacheNode cnode;
-	Size size(width, height);
+	int maxSize = glState.caps.maxTexSize;
+	if (width > maxSize || height > maxSize)
+		throw Exception(Exception::MKXPError,
+		                "Texture dimensions [%d, %d] exceed hardware capabilities",
+		                width, height);
+
+	int classW = std::min(sizeClass(width),  maxSize);
+	int classH = std::min(sizeClass(height), maxSize);
+	Size size(classW, classH);
 
 	/* See if we can statisfy request from cache */
 	CNodeList &bucket = p->poolHash[size];
 
-	if (!bucket.empty())
+	if (!bucket.isEmpty())
 	{
 		/* Found one! */
-		cnode = bucket.back();
-		bucket.pop_back();
-
-		p->priorityQueue.erase(cnode.prioIter);
-
-		p->memSize -= byteCount(size);
-		--p->objCount;
+		++p->hits;
 
 //		Debug() << "TexPool: <?+> (" << width << height << ")";
 
-		return cnode.obj;
+		return p->take(bucket.tail());
 	}
 
-	int maxSize = glState.caps.maxTexSize;
-	if (width > maxSize || height > maxSize)
-		throw Exception(Exception::MKXPError,
-		                "Texture dimensions [%d, %d] exceed hardware capabilities",
-		                width, height);
+	++p->misses;
+	p->countAlloc();
 
 	/* Nope, create it instead */
-	TEXFBO::init(cnode.obj);
-	TEXFBO::allocEmpty(cnode.obj, width, height);
-	TEXFBO::linkFBO(cnode.obj);
+	TEXFBO obj;
+	TEXFBO::init(obj);
+	TEXFBO::allocEmpty(obj, classW, classH);
+	TEXFBO::linkFBO(obj);
 
 //	Debug() << "TexPool: <?-> (" << width << height << ")";
 
-	return cnode.obj;
+	return obj;
 }
 
 void TexPool::release(TEXFBO &obj)
@@ -160,11 +231,16 @@ void TexPool::release(TEXFBO &obj)
 
 	Size size(obj.width, obj.height);
 
-	uint32_t newMemSize = p->memSize + byteCount(size);
+	/* Objects bigger than the whole budget are never retained */
+	if (byteCount(size) > p->maxMemSize)
+	{
+		TEXFBO::fini(obj);
+		return;
+	}
 
 	/* If caching this object would spill over the allowed memory budget,
 	 * delete least used objects until we're good again */
-	while (newMemSize > p->maxMemSize)
+	while (p->memSize + byteCount(size) > p->maxMemSize)
 	{
 		if (p->objCount == 0)
 			break;
@@ -172,37 +248,20 @@ void TexPool::release(TEXFBO &obj)
 //		Debug() << "TexPool: <!~> Size:" << p->memSize;
 
 		/* Retrieve object with lowest priority for deletion */
-		CacheNode last;
-		last.obj = p->priorityQueue.back();
-		Size removedSize(last.obj.width, last.obj.height);
-
-		CNodeList &bucket = p->poolHash[removedSize];
-
-		std::list<CacheNode>::iterator toRemove =
-		        std::find(bucket.begin(), bucket.end(), last);
-		assert(toRemove != bucket.end());
-		bucket.erase(toRemove);
-
-		p->priorityQueue.pop_back();
-
-		TEXFBO::fini(last.obj);
+		TEXFBO last = p->take(p->priorityQueue.tail());
+		TEXFBO::fini(last);
 
-		newMemSize -= byteCount(removedSize);
-		--p->objCount;
-
-//		Debug() << "TexPool: <!-> (" << last.obj.width << last.obj.height << ")";
+//		Debug() << "TexPool: <!-> (" << last.width << last.height << ")";
 	}
 
-	p->memSize = newMemSize;
-
 	/* Retain object */
-	p->priorityQueue.push_front(obj);
-	CacheNode cnode;
-	cnode.obj = obj;
-	cnode.prioIter = p->priorityQueue.begin();
 	CNodeList &bucket = p->poolHash[size];
-	bucket.push_back(cnode);
+	CacheNode *node = new CacheNode(obj, &bucket);
+
+	p->priorityQueue.prepend(node->prioLink);
+	bucket.append(node->bucketLink);
 
+	p->memSize += byteCount(size);
 	++p->objCount;
 
 //	Debug() << "TexPool: <!+> (" << obj.width << obj.height << ") Current size:" << p->memSize;
@@ -213,4 +272,17 @@ void TexPool::disable()
 	p->disabled = true;
 }
 
+TexPool::Stats TexPool::getStats() const
+{
+	Stats stats;
+	stats.hits = p->hits;
+	stats.misses = p->misses;
+	stats.memSize = p->memSize;
+	stats.objCount = p->objCount;
+
+	/* Let the rate decay if nothing was allocated recently */
+	uint32_t elapsed = SDL_GetTicks() - p->allocWindowStart;
+	stats.allocsPerSec = elapsed < 2000 ? p->allocsPerSec : 0;
 
+	return stats;
+}
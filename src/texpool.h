@@ -29,14 +29,40 @@ struct TexPoolPrivate;
 class TexPool
 {
 public:
+	struct Stats
+	{
+		/* Requests satisfied from / missing the cache */
+		uint32_t hits;
+		uint32_t misses;
+
+		/* Memory currently held by cached objects */
+		uint32_t memSize;
+		uint16_t objCount;
+
+		/* Fresh GL allocations during the last second */
+		uint32_t allocsPerSec;
+
+		float hitRate() const
+		{
+			uint32_t total = hits + misses;
+			return total ? (float) hits / total : 0;
+		}
+	};
+
 	TexPool(uint32_t maxMemSize = 20000000 /* 20 MB */);
 	~TexPool();
 
+	/* The returned object is at least (width, height) big, but
+	 * may be rounded up to the next size class; its 'width' and
+	 * 'height' members always reflect the real texture size.
+	 * Users have to track the requested size themselves */
 	TEXFBO request(int width, int height);
 	void release(TEXFBO &obj);
 
 	void disable();
 
+	Stats getStats() const;
+
 private:
 	TexPoolPrivate *p;
 };
@@ -21,6 +21,7 @@
 
 #include "tileatlasvx.h"
 
+#include "autotilesvx.h"
 #include "tilemap-common.h"
 #include "bitmap.h"
 #include "table.h"
@@ -35,34 +36,6 @@
 #include <assert.h>
 #include <vector>
 
-/* Regular (A) autotile patterns */
-extern const StaticRect autotileVXRectsA[];
-extern const int autotileVXRectsAN;
-
-/* Table (A2) autotile patterns */
-extern const StaticRect autotileVXRectsA2[];
-extern const int autotileVXRectsA2N;
-extern const float autotileVXRectsA2Sizes[];
-
-/* Wall (B) autotile patterns */
-extern const StaticRect autotileVXRectsB[];
-extern const int autotileVXRectsBN;
-
-/* Waterfall (C) autotile patterns */
-static const StaticRect autotileVXRectsC[] =
-{
-	{ 32.5f, 0.5f, 15.0f, 31.0f },
-	{ 16.5f, 0.5f, 15.0f, 31.0f },
-	{  0.0f, 0.5f, 15.0f, 31.0f },
-	{ 16.5f, 0.5f, 15.0f, 31.0f },
-	{ 32.5f, 0.5f, 15.0f, 31.0f },
-	{ 48.5f, 0.5f, 15.0f, 31.0f },
-	{  0.0f, 0.5f, 15.0f, 31.0f },
-	{ 48.5f, 0.5f, 15.0f, 31.0f }
-};
-
-static elementsN(autotileVXRectsC);
-
 namespace TileAtlasVX
 {
 
@@ -322,57 +295,40 @@ void build(TEXFBO &tf, Bitmap *bitmaps[BM_COUNT])
 /* Reference: http://www.tktkgame.com/tkool/memo/vx/tile_id.html */
 
 static void
-readAutotile(Reader &reader, int patternID,
-             const Vec2i &orig, int x, int y,
-             const StaticRect rectSource[], int rectSourceN)
+readAutotile(Reader &reader, const AutotilePatternVX &pat,
+             const Vec2i &orig, int x, int y)
 {
-	FloatRect tex[4], pos[4];
-	(void) rectSourceN;
+	FloatRect tex[6], pos[6];
 
-	for (int i = 0; i < 4; ++i)
+	for (int i = 0; i < pat.n; ++i)
 	{
-		assert((patternID*4 + i) < rectSourceN);
-
-		tex[i] = FloatRect(rectSource[patternID*4 + i]);
-		tex[i].x += orig.x*32;
-		tex[i].y += orig.y*32;
+		const AutotileQuadVX &q = pat.quads[i];
 
-		pos[i] = FloatRect(x*32, y*32, 16, 16);
-		atSelectSubPos(pos[i], i);
+		tex[i] = FloatRect(orig.x*32 + q.tex[0]*0.5f, orig.y*32 + q.tex[1]*0.5f,
+		                   q.tex[2]*0.5f, q.tex[3]*0.5f);
+		pos[i] = FloatRect(x*32 + q.pos[0]*0.5f, y*32 + q.pos[1]*0.5f,
+		                   q.pos[2]*0.5f, q.pos[3]*0.5f);
 	}
 
-	reader.onQuads(tex, pos, 4, false);
+	reader.onQuads(tex, pos, pat.n, false);
 }
 
 static void
 readAutotileA(Reader &reader, int patternID,
               const Vec2i &orig, int x, int y)
 {
-	readAutotile(reader, patternID, orig, x, y,
-	             autotileVXRectsA, autotileVXRectsAN);
+	assert(patternID < autotileVXPatternsAN);
+
+	readAutotile(reader, autotileVXPatternsA[patternID], orig, x, y);
 }
 
 static void
 readAutotileA2(Reader &reader, int patternID,
                const Vec2i &orig, int x, int y)
 {
-	FloatRect tex[6], pos[6];
-
-	for (int i = 0; i < 6; ++i)
-	{
-		assert((patternID*6 + i) < autotileVXRectsA2N);
-
-		tex[i] = FloatRect(autotileVXRectsA2[patternID*6 + i]);
-		tex[i].x += orig.x*32;
-		tex[i].y += orig.y*32;
-
-		float size = autotileVXRectsA2Sizes[patternID*6 + i];
+	assert(patternID < autotileVXPatternsA2N);
 
-		pos[i] = FloatRect(x*32, y*32, size, size);
-		atSelectSubPos(pos[i], i);
-	}
-
-	reader.onQuads(tex, pos, 6, false);
+	readAutotile(reader, autotileVXPatternsA2[patternID], orig, x, y);
 }
 
 static void
@@ -382,8 +338,7 @@ readAutotileB(Reader &reader, int patternID,
 	if (patternID >= 0x10)
 		return;
 
-	readAutotile(reader, patternID, orig, x, y,
-	             autotileVXRectsB, autotileVXRectsBN);
+	readAutotile(reader, autotileVXPatternsB[patternID], orig, x, y);
 }
 
 static void
@@ -393,19 +348,7 @@ readAutotileC(Reader &reader, int patternID,
 	if (patternID > 0x3)
 		return;
 
-	FloatRect tex[2], pos[2];
-
-	for (size_t i = 0; i < 2; ++i)
-	{
-		tex[i] = autotileVXRectsC[patternID*2+i];
-		tex[i].x += orig.x*32;
-		tex[i].y += orig.y*32;
-
-		pos[i] = FloatRect(x*32, y*32, 16, 32);
-		pos[i].x += i*16;
-	}
-
-	reader.onQuads(tex, pos, 2, false);
+	readAutotile(reader, autotileVXPatternsC[patternID], orig, x, y);
 }
 
 static void
@@ -655,11 +598,18 @@ void readTiles(Reader &reader, const Table &data,
                const Table *flags, int ox, int oy, int w, int h)
 {
 	for (int i = 0; i < 2; ++i)
+	{
+		reader.onLayerBegin(i);
 		readLayer(reader, data, flags, ox, oy, w, h, i);
+	}
 
 	if (rgssVer >= 3)
+	{
+		reader.onLayerBegin(2);
 		readShadowLayer(reader, data, ox, oy, w, h);
+	}
 
+	reader.onLayerBegin(3);
 	readLayer(reader, data, flags, ox, oy, w, h, 2);
 }
 
@@ -50,10 +50,17 @@ enum
 
 namespace TileAtlasVX
 {
+/* Passes of readTiles(), in drawing order: layer 0,
+ * layer 1, shadows (RGSS3 only), layer 2 */
+enum { LayerCount = 4 };
+
 struct Reader
 {
 	virtual void onQuads(const FloatRect *t, const FloatRect *p,
 	                     size_t n, bool overPlayer) = 0;
+
+	/* Called before the quads of each pass are read */
+	virtual void onLayerBegin(int) {}
 };
 
 void build(TEXFBO &tf, Bitmap *bitmaps[BM_COUNT]);
@@ -32,10 +32,14 @@
 #include "vertex.h"
 #include "quad.h"
 #include "etc-internal.h"
+#include "bitmap.h"
 
 #include <stdint.h>
 #include <assert.h>
+#include <string.h>
 #include <vector>
+#include <set>
+#include <algorithm>
 
 #include <sigc++/connection.h>
 
@@ -61,6 +65,40 @@ tableGetWrapped(const Table &t, int x, int y, int z = 0)
 	             z);
 }
 
+/* Checks whether [a, a+aLen) overlaps the range [b, b+bLen),
+ * which wraps around 'range' */
+static inline bool
+wrappedOverlap(int a, int aLen, int b, int bLen, int range)
+{
+	if (bLen >= range)
+		return true;
+
+	b = wrap(b, range);
+
+	return (a < b + bLen && b < a + aLen) || (a < b + bLen - range);
+}
+
+/* Checks whether the changed cells of 't' show up
+ * inside the (wrapping) map viewport 'viewp' */
+static inline bool
+tableChangeVisible(const Table &t, const IntRect &viewp)
+{
+	const IntRect &rect = t.changedRect();
+
+	return wrappedOverlap(rect.x, rect.w, viewp.x, viewp.w, t.xSize()) &&
+	       wrappedOverlap(rect.y, rect.h, viewp.y, viewp.h, t.ySize());
+}
+
+/* Atlas key entry for one source bitmap (0 if unusable) */
+static inline uint64_t
+atlasKeyStamp(Bitmap *bm)
+{
+	if (!bm || bm->isDisposed())
+		return 0;
+
+	return bm->contentStamp();
+}
+
 /* Calculate the tile x/y on which this pixel x/y lies */
 static inline Vec2i
 getTilePos(const Vec2i &pixelPos)
@@ -145,11 +183,15 @@ struct FlashMap
 		dataCon.disconnect();
 		dirty = true;
 
+		cells.clear();
+
 		if (!data)
 			return;
 
+		collectCells(IntRect(0, 0, data->xSize(), data->ySize()));
+
 		dataCon = data->modified.connect
-			(sigc::mem_fun(this, &FlashMap::setDirty));
+			(sigc::mem_fun(this, &FlashMap::onDataModified));
 	}
 
 	void setViewport(const IntRect &value)
@@ -177,7 +219,7 @@ struct FlashMap
 		GLMeta::vaoBind(vao);
 		glState.blendMode.pushSet(BlendAddition);
 
-		FlashMapShader &shader = shState->shaders().flashMap;
+		FlashMapShader &shader = shState->shaders().flashMap();
 		shader.bind();
 		shader.applyViewportProj();
 		shader.setAlpha(alpha);
@@ -191,9 +233,59 @@ struct FlashMap
 	}
 
 private:
-	void setDirty()
+	/* A flashing (non-zero) cell of the data table */
+	struct Cell
 	{
-		dirty = true;
+		int x, y;
+		int16_t packed;
+	};
+
+	void onDataModified()
+	{
+		const IntRect &rect = data->changedRect();
+
+		/* Drop the cells inside the changed rect and pick up
+		 * their current values again */
+		size_t kept = 0;
+
+		for (size_t i = 0; i < cells.size(); ++i)
+		{
+			const Cell &c = cells[i];
+
+			if (c.x >= rect.x && c.x < rect.x + rect.w &&
+			    c.y >= rect.y && c.y < rect.y + rect.h)
+				continue;
+
+			/* Table was shrunk */
+			if (c.x >= data->xSize() || c.y >= data->ySize())
+				continue;
+
+			cells[kept++] = c;
+		}
+
+		cells.resize(kept);
+		collectCells(rect);
+
+		if (tableChangeVisible(*data, viewp))
+			dirty = true;
+	}
+
+	void collectCells(const IntRect &rect)
+	{
+		const int x2 = std::min(rect.x + rect.w, data->xSize());
+		const int y2 = std::min(rect.y + rect.h, data->ySize());
+
+		for (int y = std::max(rect.y, 0); y < y2; ++y)
+			for (int x = std::max(rect.x, 0); x < x2; ++x)
+			{
+				int16_t packed = data->at(x, y);
+
+				if (packed == 0)
+					continue;
+
+				Cell c = { x, y, packed };
+				cells.push_back(c);
+			}
 	}
 
 	size_t quadCount() const
@@ -201,48 +293,47 @@ private:
 		return vertices.size() / 4;
 	}
 
-	bool sampleFlashColor(Vec4 &out, int x, int y) const
+	static Vec4 flashColor(int16_t packed)
 	{
-		int16_t packed = tableGetWrapped(*data, x, y);
-
-		if (packed == 0)
-			return false;
-
 		const float max = 0xF;
 
 		float b = ((packed & 0x000F) >> 0) / max;
 		float g = ((packed & 0x00F0) >> 4) / max;
 		float r = ((packed & 0x0F00) >> 8) / max;
 
-		out = Vec4(r, g, b, 1);
-
-		return true;
+		return Vec4(r, g, b, 1);
 	}
 
 	void rebuildBuffer()
 	{
 		vertices.clear();
 
-		if (!data)
+		if (!data || cells.empty())
 			return;
 
-		for (int x = 0; x < viewp.w; ++x)
-			for (int y = 0; y < viewp.h; ++y)
-			{
-				Vec4 color;
-
-				if (!sampleFlashColor(color, x+viewp.x, y+viewp.y))
-					continue;
-
-				FloatRect posRect(x*32, y*32, 32, 32);
-
-				CVertex v[4];
-				Quad::setPosRect(v, posRect);
-				Quad::setColor(v, color);
+		const int xs = data->xSize();
+		const int ys = data->ySize();
 
-				for (size_t i = 0; i < 4; ++i)
-					vertices.push_back(v[i]);
-			}
+		for (size_t i = 0; i < cells.size(); ++i)
+		{
+			const Cell &c = cells[i];
+			const Vec4 color = flashColor(c.packed);
+
+			/* The viewport wraps around the map, and may
+			 * even show the same cell more than once */
+			for (int y = wrap(c.y - viewp.y, ys); y < viewp.h; y += ys)
+				for (int x = wrap(c.x - viewp.x, xs); x < viewp.w; x += xs)
+				{
+					FloatRect posRect(x*32, y*32, 32, 32);
+
+					CVertex v[4];
+					Quad::setPosRect(v, posRect);
+					Quad::setColor(v, color);
+
+					for (size_t j = 0; j < 4; ++j)
+						vertices.push_back(v[j]);
+				}
+		}
 
 		if (vertices.size() == 0)
 			return;
@@ -268,6 +359,9 @@ private:
 	Table *data;
 	sigc::connection dataCon;
 
+	/* Non-zero cells of 'data', in no particular order */
+	std::vector<Cell> cells;
+
 	IntRect viewp;
 
 	GLMeta::VAO vao;
@@ -275,4 +369,306 @@ private:
 	std::vector<CVertex> vertices;
 };
 
+/* Maps are split into square chunks of tiles whose vertices are
+ * generated once and kept in their own buffer. Scrolling only
+ * changes which chunks are drawn, and at which offset. */
+static const int tileChunkSize = 16;
+
+/* Vertex memory built chunks may hold in total. Most maps fit
+ * entirely, so each chunk is generated once; past this, the
+ * hidden chunks used least recently are freed again */
+static const size_t tileChunkCacheBytes = 32 * 1024 * 1024;
+
+struct TileChunk
+{
+	VBO::ID vbo;
+	GLMeta::VAO vao;
+	size_t allocQuads;
+
+	/* Quad offsets of the vertex ranges the tilemap sorts the
+	 * chunk's tiles into; range i is [rangeBase[i], rangeBase[i+1]) */
+	std::vector<size_t> rangeBase;
+
+	/* Vertices need to be regenerated */
+	bool dirty;
+	/* Part of the current map viewport */
+	bool visible;
+	/* Last TileChunkGrid::update that drew it */
+	unsigned int lastUse;
+
+	TileChunk(size_t rangeCount)
+	    : allocQuads(0),
+	      rangeBase(rangeCount+1),
+	      dirty(true),
+	      visible(false),
+	      lastUse(0)
+	{
+		vbo = VBO::gen();
+
+		GLMeta::vaoFillInVertexData<SVertex>(vao);
+		vao.vbo = vbo;
+		vao.ibo = shState->globalIBO().ibo;
+		GLMeta::vaoInit(vao);
+	}
+
+	~TileChunk()
+	{
+		GLMeta::vaoFini(vao);
+		VBO::del(vbo);
+	}
+
+	size_t vertexBytes() const
+	{
+		return allocQuads * 4 * sizeof(SVertex);
+	}
+
+	/* Quads in ranges [first, last] */
+	size_t quadCount(size_t first, size_t last) const
+	{
+		return rangeBase[last+1] - rangeBase[first];
+	}
+
+	/* 'ranges' holds one vertex array per range */
+	void upload(const std::vector<SVertex> *ranges)
+	{
+		const size_t rangeCount = rangeBase.size() - 1;
+		size_t quads = 0;
+
+		for (size_t i = 0; i < rangeCount; ++i)
+		{
+			rangeBase[i] = quads;
+			quads += ranges[i].size() / 4;
+		}
+
+		rangeBase[rangeCount] = quads;
+
+		VBO::bind(vbo);
+
+		if (quads > allocQuads)
+		{
+			VBO::allocEmpty(quads * 4 * sizeof(SVertex));
+			allocQuads = quads;
+		}
+
+		for (size_t i = 0; i < rangeCount; ++i)
+		{
+			if (ranges[i].empty())
+				continue;
+
+			VBO::uploadSubData(rangeBase[i] * 4 * sizeof(SVertex),
+			                   ranges[i].size() * sizeof(SVertex), dataPtr(ranges[i]));
+		}
+
+		VBO::unbind();
+
+		shState->ensureQuadIBO(quads);
+
+		dirty = false;
+	}
+
+	/* Draws ranges [first, last]; the VAO is left bound */
+	void draw(size_t first, size_t last)
+	{
+		GLMeta::vaoBind(vao);
+
+		gl.DrawElements(GL_TRIANGLES, quadCount(first, last)*6, _GL_INDEX_TYPE,
+		                (GLvoid*) (rangeBase[first]*6*sizeof(index_t)));
+	}
+};
+
+struct VisibleChunk
+{
+	TileChunk *chunk;
+
+	/* Tile position of the chunk's top left corner,
+	 * unwrapped into the map viewport's coordinates */
+	Vec2i origin;
+};
+
+struct TileChunkBuilder
+{
+	/* Generates the vertices of the map tiles in 'tiles',
+	 * positioned relative to the rect's top left corner */
+	virtual void buildChunk(TileChunk &chunk, const IntRect &tiles) = 0;
+};
+
+class TileChunkGrid
+{
+public:
+	TileChunkGrid(size_t rangeCount, TileChunkBuilder &builder)
+	    : rangeCount(rangeCount),
+	      builder(builder),
+	      chunksX(0),
+	      chunksY(0),
+	      builtBytes(0),
+	      useCounter(0)
+	{}
+
+	~TileChunkGrid()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		for (size_t i = 0; i < chunks.size(); ++i)
+			delete chunks[i];
+
+		chunks.clear();
+		visibleChunks.clear();
+		chunksX = chunksY = 0;
+		mapSize = Vec2i();
+		builtBytes = 0;
+	}
+
+	/* Marks the chunks covering 'rect' (in tiles) for regeneration */
+	void invalidate(const IntRect &rect)
+	{
+		const int cx2 = std::min((rect.x + rect.w - 1) / tileChunkSize, chunksX - 1);
+		const int cy2 = std::min((rect.y + rect.h - 1) / tileChunkSize, chunksY - 1);
+
+		for (int cy = rect.y / tileChunkSize; cy <= cy2; ++cy)
+			for (int cx = rect.x / tileChunkSize; cx <= cx2; ++cx)
+				if (TileChunk *chunk = chunks[cy*chunksX + cx])
+					chunk->dirty = true;
+	}
+
+	void invalidateAll()
+	{
+		for (size_t i = 0; i < chunks.size(); ++i)
+			if (chunks[i])
+				chunks[i]->dirty = true;
+	}
+
+	/* Collects (and builds as needed) the chunks covering
+	 * 'mapViewp', which wraps around the map edges */
+	void update(const Vec2i &newMapSize, const IntRect &mapViewp)
+	{
+		if (newMapSize != mapSize)
+			resize(newMapSize);
+
+		for (size_t i = 0; i < visibleChunks.size(); ++i)
+			visibleChunks[i].chunk->visible = false;
+
+		visibleChunks.clear();
+
+		if (chunks.empty())
+			return;
+
+		++useCounter;
+
+		for (int ty = mapViewp.y; ty < mapViewp.y + mapViewp.h;)
+		{
+			const int cy = wrap(ty, mapSize.y) / tileChunkSize;
+			const int startY = ty - (wrap(ty, mapSize.y) - cy * tileChunkSize);
+			const int h = std::min(tileChunkSize, mapSize.y - cy * tileChunkSize);
+
+			for (int tx = mapViewp.x; tx < mapViewp.x + mapViewp.w;)
+			{
+				const int cx = wrap(tx, mapSize.x) / tileChunkSize;
+				const int startX = tx - (wrap(tx, mapSize.x) - cx * tileChunkSize);
+				const int w = std::min(tileChunkSize, mapSize.x - cx * tileChunkSize);
+
+				TileChunk *&chunk = chunks[cy*chunksX + cx];
+
+				if (!chunk)
+					chunk = new TileChunk(rangeCount);
+
+				if (chunk->dirty)
+				{
+					builtBytes -= chunk->vertexBytes();
+					builder.buildChunk(*chunk, IntRect(cx * tileChunkSize,
+					                                   cy * tileChunkSize, w, h));
+					builtBytes += chunk->vertexBytes();
+				}
+
+				chunk->visible = true;
+				chunk->lastUse = useCounter;
+
+				VisibleChunk vc = { chunk, Vec2i(startX, startY) };
+				visibleChunks.push_back(vc);
+
+				tx = startX + w;
+			}
+
+			ty = startY + h;
+		}
+
+		/* Bottom chunk row first; tiles reaching into the
+		 * row below them are then drawn after it */
+		std::reverse(visibleChunks.begin(), visibleChunks.end());
+
+		if (builtBytes > tileChunkCacheBytes)
+			freeLeastUsed();
+	}
+
+	/* Chunks covering the map viewport, bottom row first */
+	const std::vector<VisibleChunk> &visible() const
+	{
+		return visibleChunks;
+	}
+
+private:
+	void resize(const Vec2i &newMapSize)
+	{
+		clear();
+
+		if (newMapSize.x <= 0 || newMapSize.y <= 0)
+			return;
+
+		mapSize = newMapSize;
+		chunksX = (mapSize.x + tileChunkSize - 1) / tileChunkSize;
+		chunksY = (mapSize.y + tileChunkSize - 1) / tileChunkSize;
+		chunks.assign(chunksX * chunksY, 0);
+	}
+
+	static bool lessRecentlyUsed(const TileChunk *a, const TileChunk *b)
+	{
+		return a->lastUse < b->lastUse;
+	}
+
+	/* Frees hidden chunks, oldest first, down to 3/4 of the
+	 * budget so this doesn't run again on the next few frames */
+	void freeLeastUsed()
+	{
+		std::vector<TileChunk*> hidden;
+
+		for (size_t i = 0; i < chunks.size(); ++i)
+			if (chunks[i] && !chunks[i]->visible)
+				hidden.push_back(chunks[i]);
+
+		std::sort(hidden.begin(), hidden.end(), lessRecentlyUsed);
+
+		std::set<TileChunk*> freed;
+
+		for (size_t i = 0; i < hidden.size() && builtBytes > tileChunkCacheBytes / 4 * 3; ++i)
+		{
+			builtBytes -= hidden[i]->vertexBytes();
+			freed.insert(hidden[i]);
+		}
+
+		for (size_t i = 0; i < chunks.size(); ++i)
+		{
+			if (!freed.count(chunks[i]))
+				continue;
+
+			delete chunks[i];
+			chunks[i] = 0;
+		}
+	}
+
+	const size_t rangeCount;
+	TileChunkBuilder &builder;
+
+	std::vector<TileChunk*> chunks;
+	int chunksX, chunksY;
+	/* Map size the grid was laid out for */
+	Vec2i mapSize;
+	/* Vertex memory held by all built chunks */
+	size_t builtBytes;
+	unsigned int useCounter;
+
+	std::vector<VisibleChunk> visibleChunks;
+};
+
 #endif // TILEMAPCOMMON_H
@@ -69,6 +69,11 @@ static const int viewpH = 16;
 
 static const size_t zlayersMax = viewpH + 5;
 
+/* Chunk vertex ranges: the ground layer, followed by
+ * one zlayer per chunk row + priority (1 to 5) */
+static const size_t chunkZLayers = tileChunkSize + 5;
+static const size_t chunkRanges = 1 + chunkZLayers;
+
 /* Vocabulary:
  *
  * Atlas: A texture containing both the tileset and all
@@ -147,10 +152,18 @@ static const size_t zlayersMax = viewpH + 5;
  *
  * Map viewport:
  *   This rectangle describes the subregion of the map that is
- *   actually translated to vertices and stored on the GPU ready
- *   for rendering. Whenever, ox/oy are modified, its position is
- *   adjusted if necessary and the data is regenerated. Its size
- *   is fixed. This is NOT related to the RGSS Viewport class!
+ *   actually drawn. Whenever ox/oy are modified, its position is
+ *   adjusted if necessary and the chunks covering it are collected
+ *   again. Its size is fixed. This is NOT related to the RGSS
+ *   Viewport class!
+ *
+ * Chunks:
+ *   The map is translated to vertices in chunks of 16x16 tiles
+ *   which stay on the GPU until their tiles change, or, on maps
+ *   too big to keep whole, until they're the least recently
+ *   drawn (see TileChunkGrid). Each chunk keeps its ground tiles and every
+ *   zlayer it contributes to in sequential ranges, so a batch of
+ *   zlayers is still one draw call per visible chunk.
  *
  */
 
@@ -180,15 +193,11 @@ static elementsN(flashAlpha);
 
 struct GroundLayer : public ViewportElement
 {
-	GLsizei vboCount;
 	TilemapPrivate *p;
 
 	GroundLayer(TilemapPrivate *p, Viewport *viewport);
 
-	void updateVboCount();
-
 	void draw();
-	void drawInt();
 
 	void onGeometryChange(const Scene::Geometry &geo);
 
@@ -198,8 +207,6 @@ struct GroundLayer : public ViewportElement
 struct ZLayer : public ViewportElement
 {
 	size_t index;
-	GLintptr vboOffset;
-	GLsizei vboCount;
 	TilemapPrivate *p;
 
 	/* If this layer is part of a batch and not
@@ -207,15 +214,14 @@ struct ZLayer : public ViewportElement
 	bool batchedFlag;
 
 	/* If this layer is a batch head, this variable
-	 * holds the element count of the entire batch */
-	GLsizei vboBatchCount;
+	 * holds the index of the batch's last layer */
+	size_t batchEnd;
 
 	ZLayer(TilemapPrivate *p, Viewport *viewport);
 
 	void setIndex(int value);
 
 	void draw();
-	void drawInt();
 
 	static int calculateZ(TilemapPrivate *p, int index);
 
@@ -225,7 +231,7 @@ struct ZLayer : public ViewportElement
 	ABOUT_TO_ACCESS_NOOP
 };
 
-struct TilemapPrivate
+struct TilemapPrivate : public TileChunkBuilder
 {
 	Viewport *viewport;
 
@@ -256,26 +262,28 @@ struct TilemapPrivate
 
 		/* Indices of animated autotiles */
 		std::vector<uint8_t> animatedATs;
+
+		/* Mega surface tilesets only: maps each tileset row
+		 * to its row in the compacted tileset area, or -1
+		 * if the map doesn't reference it (empty otherwise) */
+		std::vector<int> megaRowMap;
+
+		/* Describes what the texture currently holds */
+		AtlasKey key;
 	} atlas;
 
 	/* Map viewport position */
 	Vec2i viewpPos;
 
-	/* Ground layer vertices */
-	SVVector groundVert;
+	TileChunkGrid chunks;
 
-	/* ZLayer vertices */
-	SVVector zlayerVert[zlayersMax];
+	/* Vertices of the chunk being built, per range */
+	SVVector chunkVert[chunkRanges];
+	/* Map position of the chunk being built */
+	Vec2i chunkOrigin;
 
-	/* Base quad indices of each zlayer
-	 * in the shared buffer */
-	size_t zlayerBases[zlayersMax+1];
-
-	/* Shared buffers for all tiles */
 	struct
 	{
-		GLMeta::VAO vao;
-		VBO::ID vbo;
 		bool animated;
 
 		/* Animation state */
@@ -302,6 +310,8 @@ struct TilemapPrivate
 	bool atlasDirty;
 	/* Affected by: mapData(.changed), priorities(.changed) */
 	bool buffersDirty;
+	/* Affected by: mapData(.changed) (mega surface tilesets only) */
+	bool megaRowsDirty;
 	/* Affected by: ox, oy */
 	bool mapViewportDirty;
 	/* Affected by: oy */
@@ -328,10 +338,12 @@ struct TilemapPrivate
 	      mapData(0),
 	      priorities(0),
 	      visible(true),
+	      chunks(chunkRanges, *this),
 	      flashAlphaIdx(0),
 	      atlasSizeDirty(false),
 	      atlasDirty(false),
 	      buffersDirty(false),
+	      megaRowsDirty(false),
 	      mapViewportDirty(false),
 	      zOrderDirty(false),
 	      tilemapReady(false)
@@ -345,15 +357,6 @@ struct TilemapPrivate
 		tiles.frameIdx = 0;
 		tiles.aniIdx = 0;
 
-		/* Init tile buffers */
-		tiles.vbo = VBO::gen();
-
-		GLMeta::vaoFillInVertexData<SVertex>(tiles.vao);
-		tiles.vao.vbo = tiles.vbo;
-		tiles.vao.ibo = shState->globalIBO().ibo;
-
-		GLMeta::vaoInit(tiles.vao);
-
 		elem.ground = new GroundLayer(this, viewport);
 
 		for (size_t i = 0; i < zlayersMax; ++i)
@@ -372,11 +375,10 @@ struct TilemapPrivate
 		for (size_t i = 0; i < zlayersMax; ++i)
 			delete elem.zlayers[i];
 
-		shState->releaseAtlasTex(atlas.gl);
+		shState->releaseAtlasTex(atlas.gl, atlas.key);
 
 		/* Destroy tile buffers */
-		GLMeta::vaoFini(tiles.vao);
-		VBO::del(tiles.vbo);
+		chunks.clear();
 
 		/* Disconnect signal handlers */
 		tilesetCon.disconnect();
@@ -407,6 +409,13 @@ struct TilemapPrivate
 		int tsH = tileset->height();
 		atlas.efTilesetH = tsH - (tsH % 32);
 
+		atlas.megaRowMap.clear();
+
+		/* Tilesets too big for a texture are paged in row
+		 * by row; only the rows used by the map go in the atlas */
+		if (tileset->isMega())
+			atlas.efTilesetH = buildMegaRowMap(atlas.megaRowMap) * 32;
+
 		atlas.size = TileAtlas::minSize(atlas.efTilesetH, glState.caps.maxTexSize);
 
 		if (atlas.size.x < 0)
@@ -414,6 +423,148 @@ struct TilemapPrivate
 		                    "Cannot allocate big enough texture for tileset atlas");
 	}
 
+	/* Marks every tileset row referenced by the
+	 * map data within 'area' (all layers) */
+	void scanMegaRows(std::vector<bool> &used, const IntRect &area)
+	{
+		used.assign(tileset->height() / 32, false);
+
+		if (!mapData)
+			return;
+
+		const int x0 = std::max(area.x, 0);
+		const int y0 = std::max(area.y, 0);
+		const int x1 = std::min(area.x + area.w, mapData->xSize());
+		const int y1 = std::min(area.y + area.h, mapData->ySize());
+
+		for (int z = 0; z < mapData->zSize(); ++z)
+			for (int y = y0; y < y1; ++y)
+				for (int x = x0; x < x1; ++x)
+				{
+					int tsInd = mapData->at(x, y, z) - 48*8;
+
+					if (tsInd < 0)
+						continue;
+
+					size_t row = tsInd / 8;
+
+					if (row < used.size())
+						used[row] = true;
+				}
+	}
+
+	/* Returns the number of used rows */
+	int buildMegaRowMap(std::vector<int> &rowMap)
+	{
+		std::vector<bool> used;
+
+		if (mapData)
+			scanMegaRows(used, IntRect(0, 0, mapData->xSize(), mapData->ySize()));
+		else
+			used.assign(tileset->height() / 32, false);
+
+		rowMap.assign(used.size(), -1);
+		int rows = 0;
+
+		for (size_t i = 0; i < used.size(); ++i)
+			if (used[i])
+				rowMap[i] = rows++;
+
+		return rows;
+	}
+
+	/* Checks whether the map data in 'area' references
+	 * tileset rows missing from the atlas. If 'area' is the
+	 * whole map, also whether the atlas holds rows no longer
+	 * referenced, so it shrinks again after a smaller map */
+	void checkMegaRows(const IntRect &area, bool wholeMap)
+	{
+		std::vector<bool> used;
+		scanMegaRows(used, area);
+
+		for (size_t i = 0; i < used.size(); ++i)
+		{
+			const bool inAtlas = i < atlas.megaRowMap.size() && atlas.megaRowMap[i] >= 0;
+
+			if ((used[i] && !inAtlas) || (wholeMap && inAtlas && !used[i]))
+			{
+				atlasSizeDirty = true;
+				return;
+			}
+		}
+	}
+
+	/* Translates blits of the compacted tileset into blits
+	 * of the mega surface, one per run of adjacent rows */
+	TileAtlas::BlitVec remapMegaBlits(const TileAtlas::BlitVec &blits)
+	{
+		std::vector<int> compactToRow(atlas.efTilesetH / 32);
+
+		for (size_t i = 0; i < atlas.megaRowMap.size(); ++i)
+			if (atlas.megaRowMap[i] >= 0)
+				compactToRow[atlas.megaRowMap[i]] = i;
+
+		TileAtlas::BlitVec result;
+
+		for (size_t i = 0; i < blits.size(); ++i)
+		{
+			const TileAtlas::Blit &b = blits[i];
+
+			for (int off = 0; off < b.h; off += 32)
+			{
+				int srcY = compactToRow[(b.src.y + off) / 32] * 32;
+				int dstY = b.dst.y + off;
+
+				if (off > 0)
+				{
+					TileAtlas::Blit &last = result.back();
+
+					if (last.src.y + last.h == srcY)
+					{
+						last.h += 32;
+						continue;
+					}
+				}
+
+				result.push_back(TileAtlas::Blit(b.src.x, srcY, b.dst.x, dstY, 32));
+			}
+		}
+
+		return result;
+	}
+
+	/* All our elements share one scene */
+	void notifyChange()
+	{
+		elem.ground->notifyChange();
+	}
+
+	void invalidateMapData()
+	{
+		buffersDirty = true;
+		notifyChange();
+
+		if (!nullOrDisposed(tileset) && tileset->isMega())
+			megaRowsDirty = true;
+	}
+
+	void onMapDataModified()
+	{
+		/* Only the changed cells can reference new rows; a
+		 * pending full check (new map data) covers them anyway */
+		if (!nullOrDisposed(tileset) && tileset->isMega() && !megaRowsDirty)
+			checkMegaRows(mapData->changedRect(), false);
+
+		chunks.invalidate(mapData->changedRect());
+
+		/* Changes outside the map viewport don't affect our buffers */
+		if (tableChangeVisible(*mapData, IntRect(viewpPos, Vec2i(viewpW, viewpH))))
+		{
+			buffersDirty = true;
+			notifyChange();
+		}
+	}
+
 	void updateAutotileInfo()
 	{
 		/* Check if and which autotiles are animated */
@@ -427,7 +578,7 @@ struct TilemapPrivate
 			if (nullOrDisposed(autotiles[i]))
 				continue;
 
-			if (autotiles[i]->megaSurface())
+			if (autotiles[i]->isMega())
 				continue;
 
 			usableATs.push_back(i);
@@ -448,16 +599,26 @@ struct TilemapPrivate
 	void invalidateAtlasSize()
 	{
 		atlasSizeDirty = true;
+		notifyChange();
 	}
 
 	void invalidateAtlasContents()
 	{
 		atlasDirty = true;
+		notifyChange();
 	}
 
 	void invalidateBuffers()
 	{
 		buffersDirty = true;
+		notifyChange();
+	}
+
+	void invalidateChunks()
+	{
+		chunks.invalidateAll();
+		buffersDirty = true;
+		notifyChange();
 	}
 
 	/* Checks for the minimum amount of data needed to display */
@@ -478,17 +639,44 @@ struct TilemapPrivate
 		updateAtlasInfo();
 
 		/* Aquire atlas tex */
-		shState->releaseAtlasTex(atlas.gl);
-		shState->requestAtlasTex(atlas.size.x, atlas.size.y, atlas.gl);
+		shState->releaseAtlasTex(atlas.gl, atlas.key);
+		shState->requestAtlasTex(atlas.size.x, atlas.size.y, atlas.gl, &atlas.key);
+
+		/* Tileset texcoords depend on the atlas layout */
+		invalidateChunks();
 
 		atlasDirty = true;
 	}
 
+	/* Identifies the atlas the current bitmaps assemble into */
+	void makeAtlasKey(AtlasKey &key)
+	{
+		key.clear();
+		key.push_back(atlasKeyStamp(tileset));
+
+		for (size_t i = 0; i < autotileCount; ++i)
+			key.push_back(atlasKeyStamp(autotiles[i]));
+
+		/* Mega surfaces can't be modified, but which of
+		 * their rows go into the atlas depends on the map */
+		key.insert(key.end(), atlas.megaRowMap.begin(), atlas.megaRowMap.end());
+	}
+
 	/* Assembles atlas from tileset and autotile bitmaps */
 	void buildAtlas()
 	{
 		updateAutotileInfo();
 
+		/* A previous tilemap (eg. before a map transfer)
+		 * may have left exactly this atlas behind */
+		AtlasKey key;
+		makeAtlasKey(key);
+
+		if (key == atlas.key)
+			return;
+
+		atlas.key.swap(key);
+
 		TileAtlas::BlitVec blits = TileAtlas::calcBlits(atlas.efTilesetH, atlas.size);
 
 		/* Clear atlas */
@@ -532,10 +720,10 @@ struct TilemapPrivate
 		GLMeta::blitEnd();
 
 		/* Blit tileset */
-		if (tileset->megaSurface())
+		if (tileset->isMega())
 		{
-			/* Mega surface tileset */
-			SDL_Surface *tsSurf = tileset->megaSurface();
+			/* Mega surface tileset; rows are inflated per run */
+			blits = remapMegaBlits(blits);
 
 			if (shState->config().subImageFix)
 			{
@@ -544,7 +732,7 @@ struct TilemapPrivate
 				glState.blend.pushSet(false);
 				glState.viewport.pushSet(IntRect(0, 0, atlas.size.x, atlas.size.y));
 
-				SimpleShader &shader = shState->shaders().simple;
+				SimpleShader &shader = shState->shaders().simple();
 				shader.bind();
 				shader.applyViewportProj();
 				shader.setTranslation(Vec2i());
@@ -555,10 +743,13 @@ struct TilemapPrivate
 				{
 					const TileAtlas::Blit &blitOp = blits[i];
 
+					int top;
+					SDL_Surface *tsSurf = tileset->megaRows(blitOp.src.y, blitOp.h, top);
+
 					Vec2i texSize;
 					shState->ensureTexSize(tsLaneW, blitOp.h, texSize);
 					shState->bindTex();
-					GLMeta::subRectImageUpload(tsSurf->w, blitOp.src.x, blitOp.src.y,
+					GLMeta::subRectImageUpload(tsSurf->w, blitOp.src.x, blitOp.src.y - top,
 					                           0, 0, tsLaneW, blitOp.h, tsSurf, GL_RGBA);
 
 					shader.setTexSize(texSize);
@@ -581,7 +772,10 @@ struct TilemapPrivate
 				{
 					const TileAtlas::Blit &blitOp = blits[i];
 
-					GLMeta::subRectImageUpload(tsSurf->w, blitOp.src.x, blitOp.src.y,
+					int top;
+					SDL_Surface *tsSurf = tileset->megaRows(blitOp.src.y, blitOp.h, top);
+
+					GLMeta::subRectImageUpload(tsSurf->w, blitOp.src.x, blitOp.src.y - top,
 					                           blitOp.dst.x, blitOp.dst.y, tsLaneW, blitOp.h, tsSurf, GL_RGBA);
 				}
 
@@ -652,10 +846,11 @@ struct TilemapPrivate
 		}
 	}
 
+	/* 'x' and 'y' are relative to the chunk being built */
 	void handleTile(int x, int y, int z)
 	{
 		int tileInd =
-			tableGetWrapped(*mapData, x + viewpPos.x, y + viewpPos.y, z);
+			mapData->at(x + chunkOrigin.x, y + chunkOrigin.y, z);
 
 		/* Check for empty space */
 		if (tileInd < 48)
@@ -672,12 +867,12 @@ struct TilemapPrivate
 		/* Prio 0 tiles are all part of the same ground layer */
 		if (prio == 0)
 		{
-			targetArray = &groundVert;
+			targetArray = &chunkVert[0];
 		}
 		else
 		{
 			int layerInd = y + prio;
-			targetArray = &zlayerVert[layerInd];
+			targetArray = &chunkVert[1 + layerInd];
 		}
 
 		/* Check for autotile */
@@ -691,6 +886,14 @@ struct TilemapPrivate
 		int tileX = tsInd % 8;
 		int tileY = tsInd / 8;
 
+		if (!atlas.megaRowMap.empty())
+		{
+			if (tileY >= (int) atlas.megaRowMap.size() || atlas.megaRowMap[tileY] < 0)
+				return;
+
+			tileY = atlas.megaRowMap[tileY];
+		}
+
 		Vec2i texPos = TileAtlas::tileToAtlasCoor(tileX, tileY, atlas.efTilesetH, atlas.size.y);
 		FloatRect texRect((float) texPos.x+0.5f, (float) texPos.y+0.5f, 31, 31);
 		FloatRect posRect(x*32, y*32, 32, 32);
@@ -702,80 +905,94 @@ struct TilemapPrivate
 			targetArray->push_back(v[i]);
 	}
 
-	void clearQuadArrays()
+	/* TileChunkBuilder */
+	void buildChunk(TileChunk &chunk, const IntRect &tiles)
 	{
-		groundVert.clear();
-
-		for (size_t i = 0; i < zlayersMax; ++i)
-			zlayerVert[i].clear();
-	}
+		for (size_t i = 0; i < chunkRanges; ++i)
+			chunkVert[i].clear();
 
-	void buildQuadArray()
-	{
-		clearQuadArrays();
+		chunkOrigin = tiles.pos();
 
-		for (int x = 0; x < viewpW; ++x)
-			for (int y = 0; y < viewpH; ++y)
+		for (int x = 0; x < tiles.w; ++x)
+			for (int y = 0; y < tiles.h; ++y)
 				for (int z = 0; z < mapData->zSize(); ++z)
 					handleTile(x, y, z);
+
+		chunk.upload(chunkVert);
 	}
 
-	static size_t quadDataSize(size_t quadCount)
+	/* Range of the chunk with origin row 'originY' which
+	 * holds zlayer 'index' (may be out of bounds) */
+	int chunkZLayer(int originY, int index) const
 	{
-		return quadCount * sizeof(SVertex) * 4;
+		return index + viewpPos.y - originY;
 	}
 
-	size_t zlayerSize(size_t index)
+	/* Number of quads in zlayer 'index' over all visible chunks */
+	size_t zlayerQuadCount(int index) const
 	{
-		return zlayerBases[index+1] - zlayerBases[index];
+		const std::vector<VisibleChunk> &visible = chunks.visible();
+		size_t count = 0;
+
+		for (size_t i = 0; i < visible.size(); ++i)
+		{
+			int l = chunkZLayer(visible[i].origin.y, index);
+
+			if (l >= 0 && l < (int) chunkZLayers)
+				count += visible[i].chunk->quadCount(1 + l, 1 + l);
+		}
+
+		return count;
 	}
 
-	void uploadBuffers()
+	/* Draws ranges [first, last] of every visible chunk, or
+	 * the ground layer if 'ground' is set */
+	void drawChunks(ShaderBase &shader, bool ground, int first = 0, int last = 0)
 	{
-		/* Calculate total quad count */
-		size_t groundQuadCount = groundVert.size() / 4;
-		size_t quadCount = groundQuadCount;
+		const std::vector<VisibleChunk> &visible = chunks.visible();
+		TileChunk *lastChunk = 0;
 
-		for (size_t i = 0; i < zlayersMax; ++i)
+		for (size_t i = 0; i < visible.size(); ++i)
 		{
-			zlayerBases[i] = quadCount;
-			quadCount += zlayerVert[i].size() / 4;
-		}
+			TileChunk *chunk = visible[i].chunk;
+			size_t r0 = 0, r1 = 0;
 
-		zlayerBases[zlayersMax] = quadCount;
+			if (!ground)
+			{
+				int l0 = std::max(chunkZLayer(visible[i].origin.y, first), 0);
+				int l1 = std::min(chunkZLayer(visible[i].origin.y, last), (int) chunkZLayers - 1);
 
-		VBO::bind(tiles.vbo);
-		VBO::allocEmpty(quadDataSize(quadCount));
+				if (l0 > l1)
+					continue;
 
-		VBO::uploadSubData(0, quadDataSize(groundQuadCount), dataPtr(groundVert));
+				r0 = 1 + l0;
+				r1 = 1 + l1;
+			}
 
-		for (size_t i = 0; i < zlayersMax; ++i)
-		{
-			if (zlayerVert[i].empty())
+			if (chunk->quadCount(r0, r1) == 0)
 				continue;
 
-			VBO::uploadSubData(quadDataSize(zlayerBases[i]),
-			                   quadDataSize(zlayerSize(i)), dataPtr(zlayerVert[i]));
+			shader.setTranslation(dispPos + (visible[i].origin - viewpPos) * 32);
+			chunk->draw(r0, r1);
+			lastChunk = chunk;
 		}
 
-		VBO::unbind();
-
-		/* Ensure global IBO size */
-		shState->ensureQuadIBO(quadCount);
+		if (lastChunk)
+			GLMeta::vaoUnbind(lastChunk->vao);
 	}
 
 	void bindShader(ShaderBase *&shaderVar)
 	{
 		if (tiles.animated)
 		{
-			TilemapShader &tilemapShader = shState->shaders().tilemap;
+			TilemapShader &tilemapShader = shState->shaders().tilemap();
 			tilemapShader.bind();
 			tilemapShader.setAniIndex(tiles.frameIdx);
 			shaderVar = &tilemapShader;
 		}
 		else
 		{
-			shaderVar = &shState->shaders().simple;
+			shaderVar = &shState->shaders().simple();
 			shaderVar->bind();
 		}
 
@@ -790,8 +1007,6 @@ struct TilemapPrivate
 
 	void updateActiveElements(std::vector<int> &zlayerInd)
 	{
-		elem.ground->updateVboCount();
-
 		for (size_t i = 0; i < zlayersMax; ++i)
 		{
 			if (i < zlayerInd.size())
@@ -814,7 +1029,7 @@ struct TilemapPrivate
 		std::vector<int> zlayerInd;
 
 		for (size_t i = 0; i < zlayersMax; ++i)
-			if (zlayerVert[i].size() > 0)
+			if (zlayerQuadCount(i) > 0)
 				zlayerInd.push_back(i);
 
 		updateActiveElements(zlayerInd);
@@ -867,7 +1082,7 @@ struct TilemapPrivate
 			ZLayer *batchHead = zlayers[i];
 			batchHead->batchedFlag = false;
 
-			GLsizei vboBatchCount = batchHead->vboCount;
+			size_t batchEnd = batchHead->index;
 			IntruListLink<SceneElement> *iter = &batchHead->link;
 
 			for (i = i+1; i < elem.activeLayers; ++i)
@@ -881,11 +1096,11 @@ struct TilemapPrivate
 				if (iter != &layer->link)
 					break;
 
-				vboBatchCount += layer->vboCount;
+				batchEnd = layer->index;
 				layer->batchedFlag = true;
 			}
 
-			batchHead->vboBatchCount = vboBatchCount;
+			batchHead->batchEnd = batchEnd;
 			--i;
 		}
 	}
@@ -916,6 +1131,14 @@ struct TilemapPrivate
 			return;
 		}
 
+		if (megaRowsDirty)
+		{
+			if (tileset->isMega() && mapData)
+				checkMegaRows(IntRect(0, 0, mapData->xSize(), mapData->ySize()), true);
+
+			megaRowsDirty = false;
+		}
+
 		if (atlasSizeDirty)
 		{
 			allocateAtlas();
@@ -936,8 +1159,8 @@ struct TilemapPrivate
 
 		if (buffersDirty)
 		{
-			buildQuadArray();
-			uploadBuffers();
+			chunks.update(Vec2i(mapData->xSize(), mapData->ySize()),
+			              IntRect(viewpPos, Vec2i(viewpW, viewpH)));
 			updateSceneElements();
 			buffersDirty = false;
 		}
@@ -958,42 +1181,23 @@ struct TilemapPrivate
 
 GroundLayer::GroundLayer(TilemapPrivate *p, Viewport *viewport)
     : ViewportElement(viewport, 0),
-      vboCount(0),
       p(p)
 {
 	onGeometryChange(scene->getGeometry());
 }
 
-void GroundLayer::updateVboCount()
-{
-	vboCount = p->zlayerBases[0] * 6;
-}
-
 void GroundLayer::draw()
 {
-	if (p->groundVert.size() == 0)
-		return;
-
 	ShaderBase *shader;
 
 	p->bindShader(shader);
 	p->bindAtlas(*shader);
 
-	GLMeta::vaoBind(p->tiles.vao);
-
-	shader->setTranslation(p->dispPos);
-	drawInt();
-
-	GLMeta::vaoUnbind(p->tiles.vao);
+	p->drawChunks(*shader, true);
 
 	p->flashMap.draw(flashAlpha[p->flashAlphaIdx] / 255.f, p->dispPos);
 }
 
-void GroundLayer::drawInt()
-{
-	gl.DrawElements(GL_TRIANGLES, vboCount, _GL_INDEX_TYPE, (GLvoid*) 0);
-}
-
 void GroundLayer::onGeometryChange(const Scene::Geometry &geo)
 {
 	p->updateSceneGeometry(geo);
@@ -1002,10 +1206,9 @@ void GroundLayer::onGeometryChange(const Scene::Geometry &geo)
 ZLayer::ZLayer(TilemapPrivate *p, Viewport *viewport)
     : ViewportElement(viewport, 0),
       index(0),
-      vboOffset(0),
-      vboCount(0),
       p(p),
-      vboBatchCount(0)
+      batchedFlag(false),
+      batchEnd(0)
 {}
 
 void ZLayer::setIndex(int value)
@@ -1014,9 +1217,6 @@ void ZLayer::setIndex(int value)
 
 	z = calculateZ(p, index);
 	scene->reinsert(*this);
-
-	vboOffset = p->zlayerBases[index] * sizeof(index_t) * 6;
-	vboCount = p->zlayerSize(index) * 6;
 }
 
 void ZLayer::draw()
@@ -1029,17 +1229,7 @@ void ZLayer::draw()
 	p->bindShader(shader);
 	p->bindAtlas(*shader);
 
-	GLMeta::vaoBind(p->tiles.vao);
-
-	shader->setTranslation(p->dispPos);
-	drawInt();
-
-	GLMeta::vaoUnbind(p->tiles.vao);
-}
-
-void ZLayer::drawInt()
-{
-	gl.DrawElements(GL_TRIANGLES, vboBatchCount, _GL_INDEX_TYPE, (GLvoid*) vboOffset);
+	p->drawChunks(*shader, false, index, batchEnd);
 }
 
 int ZLayer::calculateZ(TilemapPrivate *p, int index)
@@ -1121,14 +1311,21 @@ void Tilemap::update()
 	if (++p->flashAlphaIdx >= flashAlphaN)
 		p->flashAlphaIdx = 0;
 
+	if (p->flashMap.getData())
+		p->notifyChange();
+
 	/* Animate autotiles */
 	if (!p->tiles.animated)
 		return;
 
+	const uint8_t frameIdx = p->tiles.frameIdx;
 	p->tiles.frameIdx = atAnimation[p->tiles.aniIdx];
 
 	if (++p->tiles.aniIdx >= atAnimationN)
 		p->tiles.aniIdx = 0;
+
+	if (p->tiles.frameIdx != frameIdx)
+		p->notifyChange();
 }
 
 Tilemap::Autotiles &Tilemap::getAutotiles()
@@ -1190,10 +1387,11 @@ void Tilemap::setMapData(Table *value)
 	if (!value)
 		return;
 
-	p->invalidateBuffers();
+	p->chunks.clear();
+	p->invalidateMapData();
 	p->mapDataCon.disconnect();
 	p->mapDataCon = value->modified.connect
-	        (sigc::mem_fun(p, &TilemapPrivate::invalidateBuffers));
+	        (sigc::mem_fun(p, &TilemapPrivate::onMapDataModified));
 }
 
 void Tilemap::setFlashData(Table *value)
@@ -1201,6 +1399,7 @@ void Tilemap::setFlashData(Table *value)
 	guardDisposed();
 
 	p->flashMap.setData(value);
+	p->notifyChange();
 }
 
 void Tilemap::setPriorities(Table *value)
@@ -1211,14 +1410,14 @@ void Tilemap::setPriorities(Table *value)
 		return;
 
 	p->priorities = value;
+	p->invalidateChunks();
 
 	if (!value)
 		return;
 
-	p->invalidateBuffers();
 	p->prioritiesCon.disconnect();
 	p->prioritiesCon = value->modified.connect
-	        (sigc::mem_fun(p, &TilemapPrivate::invalidateBuffers));
+	        (sigc::mem_fun(p, &TilemapPrivate::invalidateChunks));
 }
 
 void Tilemap::setVisible(bool value)
@@ -1247,6 +1446,7 @@ void Tilemap::setOX(int value)
 
 	p->origin.x = value;
 	p->mapViewportDirty = true;
+	p->notifyChange();
 }
 
 void Tilemap::setOY(int value)
@@ -1259,6 +1459,7 @@ void Tilemap::setOY(int value)
 	p->origin.y = value;
 	p->zOrderDirty = true;
 	p->mapViewportDirty = true;
+	p->notifyChange();
 }
 
 void Tilemap::releaseResources()
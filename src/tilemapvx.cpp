@@ -51,7 +51,9 @@ static const uint8_t flashAlpha[] =
 
 static elementsN(flashAlpha);
 
-struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
+static const size_t layerCount = TileAtlasVX::LayerCount;
+
+struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader, TileChunkBuilder
 {
 	Bitmap *bitmaps[BM_COUNT];
 
@@ -65,17 +67,17 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 	Vec2i dispPos;
 	Scene::Geometry sceneGeo;
 
-	std::vector<SVertex> groundVert;
-	std::vector<SVertex> aboveVert;
-
 	TEXFBO atlas;
-	VBO::ID vbo;
-	GLMeta::VAO vao;
+	/* Describes what 'atlas' currently holds */
+	AtlasKey atlasKey;
 
-	size_t allocQuads;
+	/* Vertex ranges of each chunk: the readTiles passes
+	 * going to the ground layer, then those going above */
+	TileChunkGrid chunks;
 
-	size_t groundQuads;
-	size_t aboveQuads;
+	/* Scratch vertices of the chunk being built, per range */
+	std::vector<SVertex> layerVert[layerCount*2];
+	int curLayer;
 
 	uint16_t frameIdx;
 	Vec2 aniOffset;
@@ -118,9 +120,8 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 	    : ViewportElement(viewport),
 	      mapData(0),
 	      flags(0),
-	      allocQuads(0),
-	      groundQuads(0),
-	      aboveQuads(0),
+	      chunks(layerCount*2, *this),
+	      curLayer(0),
 	      frameIdx(0),
 	      flashAlphaIdx(0),
 	      atlasDirty(true),
@@ -130,14 +131,7 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 	{
 		memset(bitmaps, 0, sizeof(bitmaps));
 
-		shState->requestAtlasTex(ATLASVX_W, ATLASVX_H, atlas);
-
-		vbo = VBO::gen();
-
-		GLMeta::vaoFillInVertexData<SVertex>(vao);
-		vao.vbo = vbo;
-		vao.ibo = shState->globalIBO().ibo;
-		GLMeta::vaoInit(vao);
+		shState->requestAtlasTex(ATLASVX_W, ATLASVX_H, atlas, &atlasKey);
 
 		onGeometryChange(scene->getGeometry());
 
@@ -147,10 +141,9 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 
 	virtual ~TilemapVXPrivate()
 	{
-		GLMeta::vaoFini(vao);
-		VBO::del(vbo);
+		chunks.clear();
 
-		shState->releaseAtlasTex(atlas);
+		shState->releaseAtlasTex(atlas, atlasKey);
 
 		prepareCon.disconnect();
 
@@ -167,16 +160,47 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 	void invalidateAtlas()
 	{
 		atlasDirty = true;
+		notifyChange();
 	}
 
 	void invalidateBuffers()
 	{
 		buffersDirty = true;
+		notifyChange();
+	}
+
+	void invalidateChunks()
+	{
+		chunks.invalidateAll();
+		buffersDirty = true;
+		notifyChange();
+	}
+
+	void onMapDataModified()
+	{
+		chunks.invalidate(mapData->changedRect());
+
+		/* Changes outside the map viewport don't affect our buffers */
+		if (tableChangeVisible(*mapData, mapViewp))
+		{
+			buffersDirty = true;
+			notifyChange();
+		}
 	}
 
 	void rebuildAtlas()
 	{
+		AtlasKey key;
+
+		for (size_t i = 0; i < BM_COUNT; ++i)
+			key.push_back(atlasKeyStamp(bitmaps[i]));
+
+		/* Possibly left behind by the previous tilemap */
+		if (key == atlasKey)
+			return;
+
 		TileAtlasVX::build(atlas, bitmaps);
+		atlasKey.swap(key);
 	}
 
 	void updateMapViewport()
@@ -206,40 +230,16 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 		dispPos = sceneGeo.rect.pos() - wrap(combOrigin, 32) - Vec2i(0, 32);
 	}
 
-	static size_t quadBytes(size_t quads)
-	{
-		return quads * 4 * sizeof(SVertex);
-	}
-
-	void rebuildBuffers()
+	/* TileChunkBuilder */
+	void buildChunk(TileChunk &chunk, const IntRect &tiles)
 	{
-		if (!mapData)
-			return;
-
-		groundVert.clear();
-		aboveVert.clear();
+		for (size_t i = 0; i < layerCount*2; ++i)
+			layerVert[i].clear();
 
 		TileAtlasVX::readTiles(*this, *mapData, flags,
-		                       mapViewp.x, mapViewp.y, mapViewp.w, mapViewp.h);
-
-		groundQuads = groundVert.size() / 4;
-		aboveQuads = aboveVert.size() / 4;
-		size_t totalQuads = groundQuads + aboveQuads;
-
-		VBO::bind(vbo);
-
-		if (totalQuads > allocQuads)
-		{
-			VBO::allocEmpty(quadBytes(totalQuads), GL_DYNAMIC_DRAW);
-			allocQuads = totalQuads;
-		}
-
-		VBO::uploadSubData(0, quadBytes(groundQuads), dataPtr(groundVert));
-		VBO::uploadSubData(quadBytes(groundQuads), quadBytes(aboveQuads), dataPtr(aboveVert));
+		                       tiles.x, tiles.y, tiles.w, tiles.h);
 
-		VBO::unbind();
-
-		shState->ensureQuadIBO(totalQuads);
+		chunk.upload(layerVert);
 	}
 
 	void prepare()
@@ -261,7 +261,7 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 
 		if (buffersDirty)
 		{
-			rebuildBuffers();
+			chunks.update(Vec2i(mapData->xSize(), mapData->ySize()), mapViewp);
 			buffersDirty = false;
 		}
 
@@ -283,9 +283,33 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 		drawFlashLayer();
 	}
 
+	/* Draws the passes [first, first+layerCount) of all visible
+	 * chunks; each pass is finished before the next one starts */
+	void drawLayers(ShaderBase &shader, size_t first)
+	{
+		const std::vector<VisibleChunk> &visible = chunks.visible();
+		TileChunk *last = 0;
+
+		for (size_t l = first; l < first + layerCount; ++l)
+			for (size_t i = 0; i < visible.size(); ++i)
+			{
+				TileChunk *chunk = visible[i].chunk;
+
+				if (chunk->quadCount(l, l) == 0)
+					continue;
+
+				shader.setTranslation(dispPos + (visible[i].origin - mapViewp.pos()) * 32);
+				chunk->draw(l, l);
+				last = chunk;
+			}
+
+		if (last)
+			GLMeta::vaoUnbind(last->vao);
+	}
+
 	void drawGround()
 	{
-		if (groundQuads == 0)
+		if (chunks.visible().empty())
 			return;
 
 		ShaderBase *shader;
@@ -293,7 +317,7 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 		if (!nullOrDisposed(bitmaps[BM_A1]))
 		{
 			/* Animated tileset */
-			TilemapVXShader &tmShader = shState->shaders().tilemapVX;
+			TilemapVXShader &tmShader = shState->shaders().tilemapVX();
 			tmShader.bind();
 			tmShader.setAniOffset(aniOffset);
 
@@ -302,40 +326,31 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 		else
 		{
 			/* Static tileset */
-			shader = &shState->shaders().simple;
+			shader = &shState->shaders().simple();
 			shader->bind();
 		}
 
 		shader->setTexSize(Vec2i(atlas.width, atlas.height));
 		shader->applyViewportProj();
-		shader->setTranslation(dispPos);
 
 		TEX::bind(atlas.tex);
-		GLMeta::vaoBind(vao);
-
-		gl.DrawElements(GL_TRIANGLES, groundQuads*6, _GL_INDEX_TYPE, 0);
 
-		GLMeta::vaoUnbind(vao);
+		drawLayers(*shader, 0);
 	}
 
 	void drawAbove()
 	{
-		if (aboveQuads == 0)
+		if (chunks.visible().empty())
 			return;
 
-		SimpleShader &shader = shState->shaders().simple;
+		SimpleShader &shader = shState->shaders().simple();
 		shader.bind();
 		shader.setTexSize(Vec2i(atlas.width, atlas.height));
 		shader.applyViewportProj();
-		shader.setTranslation(dispPos);
 
 		TEX::bind(atlas.tex);
-		GLMeta::vaoBind(vao);
 
-		gl.DrawElements(GL_TRIANGLES, aboveQuads*6, _GL_INDEX_TYPE,
-		                (GLvoid*) (groundQuads*6*sizeof(index_t)));
-
-		GLMeta::vaoUnbind(vao);
+		drawLayers(shader, layerCount);
 	}
 
 	void drawFlashLayer()
@@ -360,11 +375,17 @@ struct TilemapVXPrivate : public ViewportElement, TileAtlasVX::Reader
 	void onQuads(const FloatRect *t, const FloatRect *p,
 	             size_t n, bool overPlayer)
 	{
-		SVertex *vert = allocVert(overPlayer ? aboveVert : groundVert, n*4);
+		std::vector<SVertex> &vec = layerVert[(overPlayer ? layerCount : 0) + curLayer];
+		SVertex *vert = allocVert(vec, n*4);
 
 		for (size_t i = 0; i < n; ++i)
 			Quad::setTexPosRect(&vert[i*4], t[i], p[i]);
 	}
+
+	void onLayerBegin(int layer)
+	{
+		curLayer = layer;
+	}
 };
 
 void TilemapVX::BitmapArray::set(int i, Bitmap *bitmap)
@@ -379,7 +400,7 @@ void TilemapVX::BitmapArray::set(int i, Bitmap *bitmap)
 		return;
 
 	p->bitmaps[i] = bitmap;
-	p->atlasDirty = true;
+	p->invalidateAtlas();
 
 	p->bmChangedCons[i].disconnect();
 	p->bmChangedCons[i] = bitmap->modified.connect
@@ -428,11 +449,20 @@ void TilemapVX::update()
 	uint8_t aniIdxA = aniIndicesA[p->frameIdx / 30];
 	uint8_t aniIdxC = aniIndicesC[p->frameIdx / 30];
 
-	p->aniOffset = Vec2(aniIdxA * 2 * 32, aniIdxC * 32);
+	const Vec2 aniOffset(aniIdxA * 2 * 32, aniIdxC * 32);
+
+	if (aniOffset.x != p->aniOffset.x || aniOffset.y != p->aniOffset.y)
+	{
+		p->aniOffset = aniOffset;
+		p->notifyChange();
+	}
 
 	/* Animate flash */
 	if (++p->flashAlphaIdx >= flashAlphaN)
 		p->flashAlphaIdx = 0;
+
+	if (p->flashMap.getData())
+		p->notifyChange();
 }
 
 TilemapVX::BitmapArray &TilemapVX::getBitmapArray()
@@ -478,11 +508,13 @@ void TilemapVX::setMapData(Table *value)
 		return;
 
 	p->mapData = value;
+	p->chunks.clear();
 	p->buffersDirty = true;
+	p->notifyChange();
 
 	p->mapDataCon.disconnect();
 	p->mapDataCon = value->modified.connect
-		(sigc::mem_fun(p, &TilemapVXPrivate::invalidateBuffers));
+		(sigc::mem_fun(p, &TilemapVXPrivate::onMapDataModified));
 }
 
 void TilemapVX::setFlashData(Table *value)
@@ -490,6 +522,7 @@ void TilemapVX::setFlashData(Table *value)
 	guardDisposed();
 
 	p->flashMap.setData(value);
+	p->notifyChange();
 }
 
 void TilemapVX::setFlags(Table *value)
@@ -500,11 +533,11 @@ void TilemapVX::setFlags(Table *value)
 		return;
 
 	p->flags = value;
-	p->buffersDirty = true;
+	p->invalidateChunks();
 
 	p->flagsCon.disconnect();
 	p->flagsCon = value->modified.connect
-		(sigc::mem_fun(p, &TilemapVXPrivate::invalidateBuffers));
+		(sigc::mem_fun(p, &TilemapVXPrivate::invalidateChunks));
 }
 
 void TilemapVX::setVisible(bool value)
@@ -524,6 +557,7 @@ void TilemapVX::setOX(int value)
 
 	p->origin.x = value;
 	p->mapViewportDirty = true;
+	p->notifyChange();
 }
 
 void TilemapVX::setOY(int value)
@@ -535,6 +569,7 @@ void TilemapVX::setOY(int value)
 
 	p->origin.y = value;
 	p->mapViewportDirty = true;
+	p->notifyChange();
 }
 
 void TilemapVX::releaseResources()
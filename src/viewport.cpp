@@ -27,9 +27,14 @@
 #include "quad.h"
 #include "glstate.h"
 #include "graphics.h"
+#include "gl-util.h"
+#include "texpool.h"
+#include "shader.h"
 
 #include <SDL_rect.h>
 
+#include <algorithm>
+
 #include <sigc++/connection.h>
 
 struct ViewportPrivate
@@ -46,6 +51,16 @@ struct ViewportPrivate
 	IntRect screenRect;
 	int isOnScreen;
 
+	/* Cached mode: the elements are composited into 'cacheTex'
+	 * (covering the screen area from the top left corner up to
+	 * the viewport's bottom right) and only composited again
+	 * when 'cacheDirty' is set */
+	bool cache;
+	bool cacheDirty;
+	TEXFBO cacheTex;
+	Vec2i cacheSize;
+	Quad cacheQuad;
+
 	EtcTemps tmp;
 
 	ViewportPrivate(int x, int y, int width, int height, Viewport *self)
@@ -53,7 +68,9 @@ struct ViewportPrivate
 	      rect(&tmp.rect),
 	      color(&tmp.color),
 	      tone(&tmp.tone),
-	      isOnScreen(false)
+	      isOnScreen(false),
+	      cache(false),
+	      cacheDirty(true)
 	{
 		rect->set(x, y, width, height);
 		updateRectCon();
@@ -62,6 +79,7 @@ struct ViewportPrivate
 	~ViewportPrivate()
 	{
 		rectCon.disconnect();
+		releaseCache();
 	}
 
 	void onRectChange()
@@ -69,6 +87,7 @@ struct ViewportPrivate
 		self->geometry.rect = rect->toIntRect();
 		self->notifyGeometryChange();
 		recomputeOnScreen();
+		cacheDirty = true;
 	}
 
 	void updateRectCon()
@@ -97,6 +116,85 @@ struct ViewportPrivate
 
 		return (rectEffective && colorToneEffective && isOnScreen);
 	}
+
+	void releaseCache()
+	{
+		if (cacheTex.tex == TEX::ID(0))
+			return;
+
+		shState->texPool().release(cacheTex);
+		cacheTex = TEXFBO();
+		cacheSize = Vec2i();
+	}
+
+	/* The cache starts out transparent, so additive and
+	 * subtractive elements would blend against nothing
+	 * instead of what's below the viewport; while any
+	 * visible element blends that way, it is bypassed */
+	bool cacheUsable()
+	{
+		for (IntruListLink<SceneElement> *iter = self->elements.begin();
+		     iter != self->elements.end(); iter = iter->next)
+		{
+			const SceneElement *e = iter->data;
+
+			if (e->getVisible() && !e->blendsNormally())
+				return false;
+		}
+
+		return true;
+	}
+
+	/* Composites the elements into the cache texture if needed
+	 * and draws it; the scissor box is already set to 'rect' */
+	void compositeCached()
+	{
+		const IntRect r = rect->toIntRect();
+		const Vec2i size(std::min(r.x + r.w, screenRect.w),
+		                 std::min(r.y + r.h, screenRect.h));
+
+		if (size.x <= 0 || size.y <= 0)
+			return;
+
+		if (size != cacheSize)
+		{
+			releaseCache();
+			cacheTex = shState->texPool().request(size.x, size.y);
+			cacheSize = size;
+			cacheDirty = true;
+		}
+
+		if (cacheDirty)
+		{
+			FBO::bind(cacheTex.fbo);
+
+			glState.clearColor.pushSet(Vec4());
+			FBO::clear();
+			glState.clearColor.pop();
+
+			self->Scene::composite();
+
+			self->scene->bindRenderTarget();
+			cacheDirty = false;
+		}
+
+		const FloatRect area(0, 0, size.x, size.y);
+		cacheQuad.setTexPosRect(area, area);
+
+		SimpleShader &shader = shState->shaders().simple();
+		shader.bind();
+		shader.applyViewportProj();
+		shader.setTranslation(Vec2i());
+		shader.setTexSize(Vec2i(cacheTex.width, cacheTex.height));
+
+		TEX::bind(cacheTex.tex);
+
+		/* Elements blended onto the transparent cache
+		 * left it with premultiplied colors */
+		glState.blendMode.pushSet(BlendPremultiplied);
+		cacheQuad.draw();
+		glState.blendMode.pop();
+	}
 };
 
 Viewport::Viewport(int x, int y, int width, int height)
@@ -151,6 +249,29 @@ DEF_ATTR_SIMPLE(Viewport, Rect,  Rect&,  *p->rect)
 DEF_ATTR_SIMPLE(Viewport, Color, Color&, *p->color)
 DEF_ATTR_SIMPLE(Viewport, Tone,  Tone&,  *p->tone)
 
+DEF_ATTR_RD_SIMPLE(Viewport, Cache, bool, p->cache)
+
+void Viewport::setCache(bool value)
+{
+	guardDisposed();
+
+	if (p->cache == value)
+		return;
+
+	p->cache = value;
+	p->cacheDirty = true;
+
+	if (!value)
+		p->releaseCache();
+}
+
+void Viewport::refresh()
+{
+	guardDisposed();
+
+	p->cacheDirty = true;
+}
+
 void Viewport::setOX(int value)
 {
 	guardDisposed();
@@ -160,6 +281,7 @@ void Viewport::setOX(int value)
 
 	geometry.orig.x = value;
 	notifyGeometryChange();
+	p->cacheDirty = true;
 }
 
 void Viewport::setOY(int value)
@@ -171,6 +293,7 @@ void Viewport::setOY(int value)
 
 	geometry.orig.y = value;
 	notifyGeometryChange();
+	p->cacheDirty = true;
 }
 
 void Viewport::initDynAttribs()
@@ -197,7 +320,17 @@ void Viewport::composite()
 	glState.scissorTest.pushSet(true);
 	glState.scissorBox.pushSet(p->rect->toIntRect());
 
-	Scene::composite();
+	if (p->cache && p->cacheUsable())
+	{
+		p->compositeCached();
+	}
+	else
+	{
+		Scene::composite();
+
+		/* Not tracked while bypassed */
+		p->cacheDirty = true;
+	}
 
 	/* If any effects are visible, request parent Scene to
 	 * render them. */
@@ -219,6 +352,24 @@ void Viewport::onGeometryChange(const Geometry &geo)
 {
 	p->screenRect = geo.rect;
 	p->recomputeOnScreen();
+	p->cacheDirty = true;
+}
+
+bool Viewport::getCullBounds(IntRect &bounds, bool &opaque) const
+{
+	bounds = p->rect->toIntRect();
+	opaque = false;
+
+	return true;
+}
+
+void Viewport::onElementsChanged()
+{
+	/* Elements keep unlinking after we're disposed */
+	if (isDisposed())
+		return;
+
+	p->cacheDirty = true;
 }
 
 void Viewport::releaseResources()
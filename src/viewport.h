@@ -44,6 +44,10 @@ public:
 	DECL_ATTR( OY,    int    )
 	DECL_ATTR( Color, Color& )
 	DECL_ATTR( Tone,  Tone&  )
+	DECL_ATTR( Cache, bool   )
+
+	/* Makes a cached viewport composite its elements anew */
+	void refresh();
 
 	void initDynAttribs();
 
@@ -54,6 +58,8 @@ private:
 	void composite();
 	void draw();
 	void onGeometryChange(const Geometry &);
+	void onElementsChanged();
+	bool getCullBounds(IntRect &bounds, bool &opaque) const;
 	bool isEffectiveViewport(Rect *&, Color *&, Tone *&) const;
 
 	void releaseResources();
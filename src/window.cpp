@@ -36,6 +36,9 @@
 
 #include <sigc++/connection.h>
 
+#include <map>
+#include <vector>
+
 template<typename T>
 struct Sides
 {
@@ -164,13 +167,137 @@ struct QuadChunk
  * BaseTex: If the window has an opacity <255, we have to prerender
  *   the base to a texture and draw that. Otherwise, we can draw the
  *   quad array directly to the screen.
+ *
+ * Frame: The prerendered base texture. Its contents only depend on
+ *   windowskin, size, back opacity and stretch mode, so it is shared
+ *   by all windows agreeing on those. Opacity is applied when drawing
+ *   it, so fading windows never have to repaint their frame.
+ *
+ * Batch: Windows directly following each other in draw order that
+ *   share a windowskin (or frame) get their bases drawn in one call
+ *   by the first of them.
  */
 
+struct WindowFrame
+{
+	struct Key
+	{
+		Bitmap *windowskin;
+		Vec2i size;
+		int backOpacity;
+		bool stretch;
+
+		Key(Bitmap *windowskin, const Vec2i &size,
+		    int backOpacity, bool stretch)
+		    : windowskin(windowskin),
+		      size(size),
+		      backOpacity(backOpacity),
+		      stretch(stretch)
+		{}
+
+		bool operator==(const Key &o) const
+		{
+			return windowskin == o.windowskin && size == o.size &&
+			       backOpacity == o.backOpacity && stretch == o.stretch;
+		}
+
+		bool operator<(const Key &o) const
+		{
+			if (windowskin != o.windowskin)
+				return windowskin < o.windowskin;
+			if (size.x != o.size.x)
+				return size.x < o.size.x;
+			if (size.y != o.size.y)
+				return size.y < o.size.y;
+			if (backOpacity != o.backOpacity)
+				return backOpacity < o.backOpacity;
+
+			return stretch < o.stretch;
+		}
+	};
+
+	const Key key;
+	TEXFBO tex;
+	int refCount;
+
+	/* Contents need to be (re)painted before use */
+	bool dirty;
+
+	sigc::connection skinModCon;
+	sigc::connection skinDispCon;
+
+	static WindowFrame *acquire(const Key &key);
+	static void release(WindowFrame *frame);
+
+private:
+	WindowFrame(const Key &key)
+	    : key(key),
+	      refCount(0),
+	      dirty(true)
+	{}
+
+	void invalidate()
+	{
+		dirty = true;
+	}
+};
+
+typedef std::map<WindowFrame::Key, WindowFrame*> FrameCache;
+static FrameCache frameCache;
+
+/* Source of WindowPrivate::baseStamp; never hands out
+ * the same value twice, even across disposed windows */
+static uint64_t baseStampCounter = 0;
+
+WindowFrame *WindowFrame::acquire(const Key &key)
+{
+	FrameCache::iterator iter = frameCache.find(key);
+
+	if (iter != frameCache.end())
+	{
+		++iter->second->refCount;
+		return iter->second;
+	}
+
+	WindowFrame *frame = new WindowFrame(key);
+	frame->tex = shState->texPool().request(key.size.x, key.size.y);
+	frame->refCount = 1;
+
+	/* The windowskin may be drawn to or disposed (and
+	 * its address reused) while the frame is alive */
+	frame->skinModCon = key.windowskin->modified.connect
+	        (sigc::mem_fun(frame, &WindowFrame::invalidate));
+	frame->skinDispCon = key.windowskin->wasDisposed.connect
+	        (sigc::mem_fun(frame, &WindowFrame::invalidate));
+
+	frameCache.insert(FrameCache::value_type(key, frame));
+
+	return frame;
+}
+
+void WindowFrame::release(WindowFrame *frame)
+{
+	if (--frame->refCount > 0)
+		return;
+
+	frameCache.erase(frame->key);
+
+	frame->skinModCon.disconnect();
+	frame->skinDispCon.disconnect();
+	shState->texPool().release(frame->tex);
+
+	delete frame;
+}
+
 struct WindowPrivate
 {
 	Bitmap *windowskin;
+	sigc::connection windowskinCon;
+	sigc::connection windowskinDispCon;
 
 	Bitmap *contents;
+	sigc::connection contentsCon;
+	sigc::connection contentsDispCon;
 
 	bool bgStretch;
 	Rect *cursorRect;
@@ -190,19 +317,42 @@ struct WindowPrivate
 	NormValue contentsOpacity;
 
 	bool baseVertDirty;
-	bool opacityDirty;
-	bool baseTexDirty;
+	bool backOpacityDirty;
 
 	ColorQuadArray baseQuadArray;
 
 	/* Used when opacity < 255 */
-	TEXFBO baseTex;
+	WindowFrame *frame;
 	bool useBaseTex;
 
 	QuadChunk backgroundVert;
 
 	Quad baseTexQuad;
 
+	/* Changes whenever our base vertices do */
+	uint64_t baseStamp;
+
+	/* Set when our base was already drawn as
+	 * part of a preceding window's batch */
+	bool batched;
+	ColorQuadArray batchQuadArray;
+
+	/* What batchQuadArray was last built from */
+	struct BatchMember
+	{
+		const WindowPrivate *w;
+		uint64_t stamp;
+		Vec2i trans;
+
+		bool operator==(const BatchMember &o) const
+		{
+			return w == o.w && stamp == o.stamp && trans == o.trans;
+		}
+	};
+
+	std::vector<BatchMember> batchKey;
+	bool batchKeyTex;
+
 	struct WindowControls : public ViewportElement
 	{
 		WindowPrivate *p;
@@ -259,8 +409,12 @@ struct WindowPrivate
 	      backOpacity(255),
 	      contentsOpacity(255),
 	      baseVertDirty(true),
-	      opacityDirty(true),
-	      baseTexDirty(true),
+	      backOpacityDirty(true),
+	      frame(0),
+	      useBaseTex(false),
+	      baseStamp(++baseStampCounter),
+	      batched(false),
+	      batchKeyTex(false),
 	      controlsElement(this, viewport),
 	      cursorAniAlphaIdx(0),
 	      pauseAniAlphaIdx(0),
@@ -279,14 +433,42 @@ struct WindowPrivate
 
 	~WindowPrivate()
 	{
-		shState->texPool().release(baseTex);
+		if (frame)
+			WindowFrame::release(frame);
+
 		cursorRectCon.disconnect();
+		windowskinCon.disconnect();
+		windowskinDispCon.disconnect();
+		contentsCon.disconnect();
+		contentsDispCon.disconnect();
 		prepareCon.disconnect();
 	}
 
+	/* Both our elements share one scene */
+	void notifyChange()
+	{
+		controlsElement.notifyChange();
+	}
+
+	void updateBitmapCons(Bitmap *bitmap, sigc::connection &modCon,
+	                      sigc::connection &dispCon)
+	{
+		modCon.disconnect();
+		dispCon.disconnect();
+
+		if (nullOrDisposed(bitmap))
+			return;
+
+		modCon = bitmap->modified.connect
+		        (sigc::mem_fun(this, &WindowPrivate::notifyChange));
+		dispCon = bitmap->wasDisposed.connect
+		        (sigc::mem_fun(this, &WindowPrivate::notifyChange));
+	}
+
 	void markControlVertDirty()
 	{
 		controlsVertDirty = true;
+		notifyChange();
 	}
 
 	void refreshCursorRectCon()
@@ -372,46 +554,45 @@ struct WindowPrivate
 		FloatRect texRect = FloatRect(0, 0, size.x, size.y);
 		baseTexQuad.setTexPosRect(texRect, texRect);
 
-		opacityDirty = true;
-		baseTexDirty = true;
+		backOpacityDirty = true;
 	}
 
 	void updateBaseAlpha()
 	{
 		/* This is always applied unconditionally */
 		backgroundVert.setAlpha(backOpacity.norm);
-
-		baseTexQuad.setColor(Vec4(1, 1, 1, opacity.norm));
-
-		baseTexDirty = true;
 	}
 
-	void ensureBaseTexReady()
+	void ensureFrameReady()
 	{
-		/* Make sure texture is properly sized */
-		int newW = findNextPow2(size.x);
-		int newH = findNextPow2(size.y);
+		WindowFrame::Key key(windowskin, size, backOpacity, bgStretch);
+
+		if (!frame || !(frame->key == key))
+		{
+			WindowFrame *newFrame = WindowFrame::acquire(key);
+
+			if (frame)
+				WindowFrame::release(frame);
+
+			frame = newFrame;
+		}
 
-		if (newW != baseTex.width || newH != baseTex.height)
+		if (frame->dirty)
 		{
-			shState->texPool().release(baseTex);
-			baseTex = shState->texPool().request(newW, newH);
-			baseTexDirty = true;
+			redrawFrame();
+			frame->dirty = false;
 		}
 	}
 
-	void redrawBaseTex()
+	void redrawFrame()
 	{
-		/* Discard old buffer */
-		TEX::bind(baseTex.tex);
-		TEX::allocEmpty(baseTex.width, baseTex.height);
-		TEX::unbind();
+		TEXFBO &baseTex = frame->tex;
 
 		FBO::bind(baseTex.fbo);
 		glState.viewport.pushSet(IntRect(0, 0, baseTex.width, baseTex.height));
 		glState.clearColor.pushSet(Vec4());
 
-		SimpleAlphaShader &shader = shState->shaders().simpleAlpha;
+		SimpleAlphaShader &shader = shState->shaders().simpleAlpha();
 		shader.bind();
 		shader.applyViewportProj();
 		shader.setTranslation(Vec2i());
@@ -497,6 +678,8 @@ struct WindowPrivate
 
 	void prepare()
 	{
+		batched = false;
+
 		if (size.x <= 0 || size.y <= 0)
 			return;
 
@@ -509,50 +692,59 @@ struct WindowPrivate
 			updateBaseQuadArray = true;
 		}
 
-		if (opacityDirty)
+		if (backOpacityDirty)
 		{
 			updateBaseAlpha();
-			opacityDirty = false;
+			backOpacityDirty = false;
 			updateBaseQuadArray = true;
 		}
 
 		if (updateBaseQuadArray)
+		{
 			baseQuadArray.commit();
+			baseStamp = ++baseStampCounter;
+		}
 
 		/* If opacity has effect, we must prerender to a texture
 		 * and then draw this texture instead of the quad array */
 		useBaseTex = opacity < 255;
 
-		if (useBaseTex)
-		{
-			ensureBaseTexReady();
+		if (useBaseTex && !nullOrDisposed(windowskin))
+			ensureFrameReady();
+	}
 
-			if (baseTexDirty)
-			{
-				redrawBaseTex();
-				baseTexDirty = false;
-			}
-		}
+	bool hasBase() const
+	{
+		return !nullOrDisposed(windowskin) && size.x > 0 && size.y > 0;
 	}
 
-	void drawBase()
+	/* Whether 'o' can have its base drawn in the same call as ours */
+	bool canBatchWith(const WindowPrivate &o) const
 	{
-		if (nullOrDisposed(windowskin))
-			return;
+		if (!o.hasBase() || o.windowskin != windowskin)
+			return false;
 
-		if (size == Vec2i(0, 0))
+		if (o.useBaseTex != useBaseTex)
+			return false;
+
+		return !useBaseTex || o.frame == frame;
+	}
+
+	void drawBase()
+	{
+		if (!hasBase())
 			return;
 
-		SimpleAlphaShader &shader = shState->shaders().simpleAlpha;
+		SimpleAlphaShader &shader = shState->shaders().simpleAlpha();
 		shader.bind();
 		shader.applyViewportProj();
 		shader.setTranslation(position + sceneOffset);
 
 		if (useBaseTex)
 		{
-			shader.setTexSize(Vec2i(baseTex.width, baseTex.height));
+			shader.setTexSize(Vec2i(frame->tex.width, frame->tex.height));
 
-			TEX::bind(baseTex.tex);
+			TEX::bind(frame->tex.tex);
 			baseTexQuad.draw();
 		}
 		else
@@ -566,6 +758,80 @@ struct WindowPrivate
 		}
 	}
 
+	void appendBatchVert(const Vertex *vert, size_t count, const Vec2i &trans)
+	{
+		for (size_t i = 0; i < count; ++i)
+		{
+			Vertex v = vert[i];
+			v.pos.x += trans.x;
+			v.pos.y += trans.y;
+
+			batchQuadArray.vertices.push_back(v);
+		}
+	}
+
+	/* Draws our base together with those of 'others'
+	 * (which all pass canBatchWith()) */
+	void drawBaseBatch(const std::vector<WindowPrivate*> &others)
+	{
+		/* Only rebuilt when a member was added, removed, moved
+		 * or changed its vertices (geometry, opacity) */
+		std::vector<BatchMember> key(others.size() + 1);
+
+		for (size_t i = 0; i < key.size(); ++i)
+		{
+			const WindowPrivate &w = (i == 0) ? *this : *others[i-1];
+
+			key[i].w = &w;
+			key[i].stamp = w.baseStamp;
+			key[i].trans = w.position + w.sceneOffset;
+		}
+
+		if (key != batchKey || useBaseTex != batchKeyTex)
+		{
+			batchQuadArray.clear();
+
+			for (size_t i = 0; i < key.size(); ++i)
+			{
+				const WindowPrivate &w = *key[i].w;
+
+				if (useBaseTex)
+					appendBatchVert(w.baseTexQuad.vert, 4, key[i].trans);
+				else
+					appendBatchVert(w.baseQuadArray.vertices.data(),
+					                w.baseQuadArray.vertices.size(), key[i].trans);
+			}
+
+			batchQuadArray.quadCount = batchQuadArray.vertices.size() / 4;
+			batchQuadArray.commit();
+
+			batchKey.swap(key);
+			batchKeyTex = useBaseTex;
+		}
+
+		SimpleAlphaShader &shader = shState->shaders().simpleAlpha();
+		shader.bind();
+		shader.applyViewportProj();
+		shader.setTranslation(Vec2i());
+
+		if (useBaseTex)
+		{
+			shader.setTexSize(Vec2i(frame->tex.width, frame->tex.height));
+
+			TEX::bind(frame->tex.tex);
+			batchQuadArray.draw();
+		}
+		else
+		{
+			windowskin->bindTex(shader);
+			TEX::setSmooth(true);
+
+			batchQuadArray.draw();
+
+			TEX::setSmooth(false);
+		}
+	}
+
 	void drawControls()
 	{
 		if (nullOrDisposed(windowskin) && nullOrDisposed(contents))
@@ -591,7 +857,7 @@ struct WindowPrivate
 		glState.scissorBox.push();
 		glState.scissorBox.setIntersect(windowRect);
 
-		SimpleAlphaShader &shader = shState->shaders().simpleAlpha;
+		SimpleAlphaShader &shader = shState->shaders().simpleAlpha();
 		shader.bind();
 		shader.applyViewportProj();
 
@@ -648,7 +914,10 @@ struct WindowPrivate
 		}
 
 		if (updateArray)
+		{
 			controlsQuadArray.commit();
+			notifyChange();
+		}
 	}
 
 	void stepAnimations()
@@ -684,10 +953,10 @@ void Window::update()
 	p->stepAnimations();
 }
 
-DEF_ATTR_SIMPLE(Window, X,          int,     p->position.x)
-DEF_ATTR_SIMPLE(Window, Y,          int,     p->position.y)
 DEF_ATTR_SIMPLE(Window, CursorRect, Rect&,  *p->cursorRect)
 
+DEF_ATTR_RD_SIMPLE(Window, X,               int,     p->position.x)
+DEF_ATTR_RD_SIMPLE(Window, Y,               int,     p->position.y)
 DEF_ATTR_RD_SIMPLE(Window, Windowskin,      Bitmap*, p->windowskin)
 DEF_ATTR_RD_SIMPLE(Window, Contents,        Bitmap*, p->contents)
 DEF_ATTR_RD_SIMPLE(Window, Stretch,         bool,    p->bgStretch)
@@ -701,11 +970,35 @@ DEF_ATTR_RD_SIMPLE(Window, Opacity,         int,     p->opacity)
 DEF_ATTR_RD_SIMPLE(Window, BackOpacity,     int,     p->backOpacity)
 DEF_ATTR_RD_SIMPLE(Window, ContentsOpacity, int,     p->contentsOpacity)
 
+void Window::setX(int value)
+{
+	guardDisposed();
+
+	if (p->position.x == value)
+		return;
+
+	p->position.x = value;
+	p->notifyChange();
+}
+
+void Window::setY(int value)
+{
+	guardDisposed();
+
+	if (p->position.y == value)
+		return;
+
+	p->position.y = value;
+	p->notifyChange();
+}
+
 void Window::setWindowskin(Bitmap *value)
 {
 	guardDisposed();
 
 	p->windowskin = value;
+	p->updateBitmapCons(value, p->windowskinCon, p->windowskinDispCon);
+	p->notifyChange();
 
 	if (nullOrDisposed(value))
 		return;
@@ -722,6 +1015,8 @@ void Window::setContents(Bitmap *value)
 
 	p->contents = value;
 	p->controlsVertDirty = true;
+	p->updateBitmapCons(value, p->contentsCon, p->contentsDispCon);
+	p->notifyChange();
 
 	if (nullOrDisposed(value))
 		return;
@@ -739,6 +1034,7 @@ void Window::setStretch(bool value)
 
 	p->bgStretch = value;
 	p->baseVertDirty = true;
+	p->notifyChange();
 }
 
 void Window::setActive(bool value)
@@ -750,6 +1046,7 @@ void Window::setActive(bool value)
 
 	p->active = value;
 	p->cursorAniAlphaIdx = 0;
+	p->notifyChange();
 }
 
 void Window::setPause(bool value)
@@ -763,6 +1060,7 @@ void Window::setPause(bool value)
 	p->pauseAniAlphaIdx = 0;
 	p->pauseAniQuadIdx = 0;
 	p->controlsVertDirty = true;
+	p->notifyChange();
 }
 
 void Window::setWidth(int value)
@@ -774,6 +1072,7 @@ void Window::setWidth(int value)
 
 	p->size.x = value;
 	p->baseVertDirty = true;
+	p->notifyChange();
 }
 
 void Window::setHeight(int value)
@@ -785,6 +1084,7 @@ void Window::setHeight(int value)
 
 	p->size.y = value;
 	p->baseVertDirty = true;
+	p->notifyChange();
 }
 
 void Window::setOX(int value)
@@ -796,6 +1096,7 @@ void Window::setOX(int value)
 
 	p->contentsOffset.x = value;
 	p->controlsVertDirty = true;
+	p->notifyChange();
 }
 
 void Window::setOY(int value)
@@ -807,6 +1108,7 @@ void Window::setOY(int value)
 
 	p->contentsOffset.y = value;
 	p->controlsVertDirty = true;
+	p->notifyChange();
 }
 
 void Window::setOpacity(int value)
@@ -817,7 +1119,9 @@ void Window::setOpacity(int value)
 		return;
 
 	p->opacity = value;
-	p->opacityDirty = true;
+	p->baseTexQuad.setColor(Vec4(1, 1, 1, p->opacity.norm));
+	p->baseStamp = ++baseStampCounter;
+	p->notifyChange();
 }
 
 void Window::setBackOpacity(int value)
@@ -828,7 +1132,8 @@ void Window::setBackOpacity(int value)
 		return;
 
 	p->backOpacity = value;
-	p->opacityDirty = true;
+	p->backOpacityDirty = true;
+	p->notifyChange();
 }
 
 void Window::setContentsOpacity(int value)
@@ -840,6 +1145,7 @@ void Window::setContentsOpacity(int value)
 
 	p->contentsOpacity = value;
 	p->contentsQuad.setColor(Vec4(1, 1, 1, p->contentsOpacity.norm));
+	p->notifyChange();
 }
 
 void Window::initDynAttribs()
@@ -851,7 +1157,32 @@ void Window::initDynAttribs()
 
 void Window::draw()
 {
-	p->drawBase();
+	if (p->batched)
+		return;
+
+	/* Collect the windows directly following us in draw
+	 * order whose bases can be drawn in the same call */
+	std::vector<WindowPrivate*> batch;
+
+	if (p->hasBase())
+	{
+		for (IntruListLink<SceneElement> *iter = SceneElement::link.next;
+		     iter != scene->elements.end(); iter = iter->next)
+		{
+			Window *w = dynamic_cast<Window*>(iter->data);
+
+			if (!w || !w->visible || !p->canBatchWith(*w->p))
+				break;
+
+			w->p->batched = true;
+			batch.push_back(w->p);
+		}
+	}
+
+	if (batch.empty())
+		p->drawBase();
+	else
+		p->drawBaseBatch(batch);
 }
 
 void Window::onGeometryChange(const Scene::Geometry &geo)
@@ -150,9 +150,15 @@ static elementsN(pauseQuad);
 
 struct WindowVXPrivate
 {
+	WindowVX *self;
+
 	Bitmap *windowskin;
+	sigc::connection windowskinCon;
+	sigc::connection windowskinDispCon;
 
 	Bitmap *contents;
+	sigc::connection contentsCon;
+	sigc::connection contentsDispCon;
 
 	Rect *cursorRect;
 	bool active;
@@ -221,8 +227,9 @@ struct WindowVXPrivate
 
 	Vec2i sceneOffset;
 
-	WindowVXPrivate(int x, int y, int w, int h)
-	    : windowskin(0),
+	WindowVXPrivate(WindowVX *self, int x, int y, int w, int h)
+	    : self(self),
+	      windowskin(0),
 	      contents(0),
 	      cursorRect(&tmp.rect),
 	      active(true),
@@ -277,17 +284,43 @@ struct WindowVXPrivate
 
 		cursorRectCon.disconnect();
 		toneCon.disconnect();
+		windowskinCon.disconnect();
+		windowskinDispCon.disconnect();
+		contentsCon.disconnect();
+		contentsDispCon.disconnect();
 		prepareCon.disconnect();
 	}
 
+	void notifyChange()
+	{
+		self->notifyChange();
+	}
+
+	void updateBitmapCons(Bitmap *bitmap, sigc::connection &modCon,
+	                      sigc::connection &dispCon)
+	{
+		modCon.disconnect();
+		dispCon.disconnect();
+
+		if (nullOrDisposed(bitmap))
+			return;
+
+		modCon = bitmap->modified.connect
+		        (sigc::mem_fun(this, &WindowVXPrivate::notifyChange));
+		dispCon = bitmap->wasDisposed.connect
+		        (sigc::mem_fun(this, &WindowVXPrivate::notifyChange));
+	}
+
 	void invalidateCursorVert()
 	{
 		cursorVertDirty = true;
+		notifyChange();
 	}
 
 	void invalidateBaseTex()
 	{
 		base.texDirty = true;
+		notifyChange();
 	}
 
 	void refreshCursorRectCon()
@@ -427,7 +460,7 @@ struct WindowVXPrivate
 
 		if (backOpacity < 255 || tone->hasEffect())
 		{
-			PlaneShader &planeShader = shState->shaders().plane;
+			PlaneShader &planeShader = shState->shaders().plane();
 			planeShader.bind();
 
 			planeShader.setColor(Vec4());
@@ -439,7 +472,7 @@ struct WindowVXPrivate
 		}
 		else
 		{
-			shader = &shState->shaders().simple;
+			shader = &shState->shaders().simple();
 			shader->bind();
 		}
 
@@ -461,9 +494,9 @@ struct WindowVXPrivate
 		glState.blendMode.set(BlendNormal);
 
 		/* If we used plane shader before, switch to simple */
-		if (shader != &shState->shaders().simple)
+		if (shader != &shState->shaders().simple())
 		{
-			shader = &shState->shaders().simple;
+			shader = &shState->shaders().simple();
 			shader->bind();
 			shader->setTranslation(Vec2i());
 			shader->applyViewportProj();
@@ -732,7 +765,7 @@ struct WindowVXPrivate
 
 		Vec2i trans = geo.pos() + sceneOffset;
 
-		SimpleAlphaShader &shader = shState->shaders().simpleAlpha;
+		SimpleAlphaShader &shader = shState->shaders().simpleAlpha();
 		shader.bind();
 		shader.applyViewportProj();
 
@@ -817,14 +850,14 @@ struct WindowVXPrivate
 WindowVX::WindowVX(Viewport *viewport)
     : ViewportElement(viewport, DEF_Z, DEF_SPRITE_Y)
 {
-	p = new WindowVXPrivate(0, 0, 0, 0);
+	p = new WindowVXPrivate(this, 0, 0, 0, 0);
 	onGeometryChange(scene->getGeometry());
 }
 
 WindowVX::WindowVX(int x, int y, int width, int height)
     : ViewportElement(0, DEF_Z, DEF_SPRITE_Y)
 {
-	p = new WindowVXPrivate(x, y, width, height);
+	p = new WindowVXPrivate(this, x, y, width, height);
 	onGeometryChange(scene->getGeometry());
 }
 
@@ -841,6 +874,9 @@ void WindowVX::update()
 
 	p->updatePauseQuad();
 	p->updateCursorAlpha();
+
+	if (p->pause || (p->active && !p->cursorRect->isEmpty()))
+		p->notifyChange();
 }
 
 void WindowVX::move(int x, int y, int width, int height)
@@ -862,6 +898,7 @@ void WindowVX::move(int x, int y, int width, int height)
 
 	p->geo = IntRect(Vec2i(x, y), size);
 	p->updateBaseQuad();
+	p->notifyChange();
 }
 
 bool WindowVX::isOpen() const
@@ -878,11 +915,11 @@ bool WindowVX::isClosed() const
 	return p->openness == 0;
 }
 
-DEF_ATTR_SIMPLE(WindowVX, X,          int,     p->geo.x)
-DEF_ATTR_SIMPLE(WindowVX, Y,          int,     p->geo.y)
 DEF_ATTR_SIMPLE(WindowVX, CursorRect, Rect&,  *p->cursorRect)
 DEF_ATTR_SIMPLE(WindowVX, Tone,       Tone&,  *p->tone)
 
+DEF_ATTR_RD_SIMPLE(WindowVX, X,               int,     p->geo.x)
+DEF_ATTR_RD_SIMPLE(WindowVX, Y,               int,     p->geo.y)
 DEF_ATTR_RD_SIMPLE(WindowVX, Windowskin,      Bitmap*, p->windowskin)
 DEF_ATTR_RD_SIMPLE(WindowVX, Contents,        Bitmap*, p->contents)
 DEF_ATTR_RD_SIMPLE(WindowVX, Active,          bool,    p->active)
@@ -899,6 +936,28 @@ DEF_ATTR_RD_SIMPLE(WindowVX, BackOpacity,     int,     p->backOpacity)
 DEF_ATTR_RD_SIMPLE(WindowVX, ContentsOpacity, int,     p->contentsOpacity)
 DEF_ATTR_RD_SIMPLE(WindowVX, Openness,        int,     p->openness)
 
+void WindowVX::setX(int value)
+{
+	guardDisposed();
+
+	if (p->geo.x == value)
+		return;
+
+	p->geo.x = value;
+	p->notifyChange();
+}
+
+void WindowVX::setY(int value)
+{
+	guardDisposed();
+
+	if (p->geo.y == value)
+		return;
+
+	p->geo.y = value;
+	p->notifyChange();
+}
+
 void WindowVX::setWindowskin(Bitmap *value)
 {
 	guardDisposed();
@@ -908,6 +967,8 @@ void WindowVX::setWindowskin(Bitmap *value)
 
 	p->windowskin = value;
 	p->base.texDirty = true;
+	p->updateBitmapCons(value, p->windowskinCon, p->windowskinDispCon);
+	p->notifyChange();
 }
 
 void WindowVX::setContents(Bitmap *value)
@@ -918,6 +979,8 @@ void WindowVX::setContents(Bitmap *value)
 		return;
 
 	p->contents = value;
+	p->updateBitmapCons(value, p->contentsCon, p->contentsDispCon);
+	p->notifyChange();
 
 	if (nullOrDisposed(value))
 		return;
@@ -937,6 +1000,7 @@ void WindowVX::setActive(bool value)
 	p->active = value;
 	p->cursorAlphaIdx = cursorAlphaResetIdx;
 	p->updateCursorAlpha();
+	p->notifyChange();
 }
 
 void WindowVX::setArrowsVisible(bool value)
@@ -948,6 +1012,7 @@ void WindowVX::setArrowsVisible(bool value)
 
 	p->arrowsVisible = value;
 	p->ctrlVertDirty = true;
+	p->notifyChange();
 }
 
 void WindowVX::setPause(bool value)
@@ -961,6 +1026,7 @@ void WindowVX::setPause(bool value)
 	p->pauseAlphaIdx = 0;
 	p->pauseQuadIdx = 0;
 	p->ctrlVertDirty = true;
+	p->notifyChange();
 }
 
 void WindowVX::setWidth(int value)
@@ -977,6 +1043,7 @@ void WindowVX::setWidth(int value)
 	p->clipRectDirty = true;
 	p->ctrlVertDirty = true;
 	p->updateBaseQuad();
+	p->notifyChange();
 }
 
 void WindowVX::setHeight(int value)
@@ -993,6 +1060,7 @@ void WindowVX::setHeight(int value)
 	p->clipRectDirty = true;
 	p->ctrlVertDirty = true;
 	p->updateBaseQuad();
+	p->notifyChange();
 }
 
 void WindowVX::setOX(int value)
@@ -1004,6 +1072,7 @@ void WindowVX::setOX(int value)
 
 	p->contentsOff.x = value;
 	p->ctrlVertDirty = true;
+	p->notifyChange();
 }
 
 void WindowVX::setOY(int value)
@@ -1015,6 +1084,7 @@ void WindowVX::setOY(int value)
 
 	p->contentsOff.y = value;
 	p->ctrlVertDirty = true;
+	p->notifyChange();
 }
 
 void WindowVX::setPadding(int value)
@@ -1027,6 +1097,7 @@ void WindowVX::setPadding(int value)
 	p->padding = value;
 	p->paddingBottom = value;
 	p->clipRectDirty = true;
+	p->notifyChange();
 }
 
 void WindowVX::setPaddingBottom(int value)
@@ -1038,6 +1109,7 @@ void WindowVX::setPaddingBottom(int value)
 
 	p->paddingBottom = value;
 	p->clipRectDirty = true;
+	p->notifyChange();
 }
 
 void WindowVX::setOpacity(int value)
@@ -1049,6 +1121,7 @@ void WindowVX::setOpacity(int value)
 
 	p->opacity = value;
 	p->base.quad.setColor(Vec4(1, 1, 1, p->opacity.norm));
+	p->notifyChange();
 }
 
 void WindowVX::setBackOpacity(int value)
@@ -1060,6 +1133,7 @@ void WindowVX::setBackOpacity(int value)
 
 	p->backOpacity = value;
 	p->base.texDirty = true;
+	p->notifyChange();
 }
 
 void WindowVX::setContentsOpacity(int value)
@@ -1071,6 +1145,7 @@ void WindowVX::setContentsOpacity(int value)
 
 	p->contentsOpacity = value;
 	p->contentsQuad.setColor(Vec4(1, 1, 1, p->contentsOpacity.norm));
+	p->notifyChange();
 }
 
 void WindowVX::setOpenness(int value)
@@ -1082,6 +1157,7 @@ void WindowVX::setOpenness(int value)
 
 	p->openness = value;
 	p->updateBaseQuad();
+	p->notifyChange();
 }
 
 void WindowVX::initDynAttribs()